@@ -0,0 +1,377 @@
+/**
+ * micro-benchmarks for sjtu::linked_hashmap against std::unordered_map.
+ *
+ * Every operation runs for each map flavour (engine and allocator) and
+ * key type; sizes go from 1e3 to 1e7 (1e6 for the heavier key types)
+ * and the lookups also sweep the max load factor. Filter with e.g.
+ *   ./linked_hashmap_bench --benchmark_filter='FindHit<swiss, int_keys>'
+ *
+ * linked_hashmap_bench_prefetch is the same suite built with
+ * SJTU_LINKED_HASHMAP_CHAIN_PREFETCH; compare the two on the 1e7 rows.
+ */
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "linked_hashmap.hpp"
+#include "compact_linked_hashmap.hpp"
+#include "dense_linked_hashmap.hpp"
+
+namespace {
+
+// Key types. make(i) is injective, so even i and odd i never collide:
+// even indices are stored, odd ones are the lookups that miss.
+
+inline unsigned int scramble(size_t i) {
+	return static_cast<unsigned int>(i) * 2654435761u;
+}
+
+struct int_keys {
+	typedef int key_type;
+	typedef std::hash<int> hash;
+	typedef std::equal_to<int> equal;
+
+	static key_type make(size_t i) {
+		return static_cast<int>(scramble(i));
+	}
+};
+
+// long enough to defeat the small-string optimisation
+struct string_keys {
+	typedef std::string key_type;
+	typedef std::hash<std::string> hash;
+	typedef std::equal_to<std::string> equal;
+
+	static key_type make(size_t i) {
+		return "linked_hashmap/key/" + std::to_string(scramble(i));
+	}
+};
+
+// the user-defined key of data/testsix
+class Integer {
+public:
+	int val;
+	Integer(int val) : val(val) {}
+};
+
+struct integer_keys {
+	typedef Integer key_type;
+
+	struct hash {
+		unsigned int operator()(const Integer &key) const {
+			return std::hash<int>()(key.val);
+		}
+	};
+
+	struct equal {
+		bool operator()(const Integer &lhs, const Integer &rhs) const {
+			return lhs.val == rhs.val;
+		}
+	};
+
+	static key_type make(size_t i) {
+		return Integer(static_cast<int>(scramble(i)));
+	}
+};
+
+// Map flavours, each a template over the key type.
+
+template<class Keys>
+using std_unordered = std::unordered_map<typename Keys::key_type, int, typename Keys::hash, typename Keys::equal>;
+
+template<class Keys, class Engine, template<class> class Alloc = sjtu::pool_allocator>
+using sjtu_map = sjtu::linked_hashmap<typename Keys::key_type, int, typename Keys::hash, typename Keys::equal,
+	Alloc<sjtu::pair<const typename Keys::key_type, int> >, Engine>;
+
+template<class Keys>
+using chained = sjtu_map<Keys, sjtu::chained_buckets<> >;
+
+template<class Keys>
+using chained_std_alloc = sjtu_map<Keys, sjtu::chained_buckets<>, std::allocator>;
+
+template<class Keys>
+using chained_prime = sjtu_map<Keys, sjtu::chained_buckets<sjtu::prime_modulo> >;
+
+template<class Keys>
+using incremental = sjtu_map<Keys, sjtu::incremental_chained<> >;
+
+template<class Keys>
+using robin_hood = sjtu_map<Keys, sjtu::open_addressing<> >;
+
+template<class Keys>
+using swiss = sjtu_map<Keys, sjtu::swiss_groups>;
+
+template<class Keys>
+using compact = sjtu::compact_linked_hashmap<typename Keys::key_type, int, typename Keys::hash, typename Keys::equal>;
+
+template<class Keys>
+using dense = sjtu::dense_linked_hashmap<typename Keys::key_type, int, typename Keys::hash, typename Keys::equal>;
+
+// Inputs, generated once per key type and size.
+
+template<class Keys>
+struct key_set {
+	std::vector<typename Keys::key_type> stored; // insertion order
+	std::vector<typename Keys::key_type> hits; // stored keys, shuffled
+	std::vector<typename Keys::key_type> misses;
+
+	static const key_set &get(size_t n) {
+		static std::map<size_t, std::unique_ptr<key_set> > cache;
+		std::unique_ptr<key_set> &entry = cache[n];
+		if (!entry) {
+			entry.reset(new key_set);
+			std::mt19937 rng(static_cast<unsigned int>(n));
+			for (size_t i = 0; i < n; ++i) {
+				entry->stored.push_back(Keys::make(2 * i));
+				entry->misses.push_back(Keys::make(2 * i + 1));
+			}
+			entry->hits = entry->stored;
+			std::shuffle(entry->hits.begin(), entry->hits.end(), rng);
+		}
+		return *entry;
+	}
+};
+
+float max_load(const benchmark::State &state) {
+	return state.range(1) / 100.0f;
+}
+
+template<class Map, class Keys>
+std::unique_ptr<Map> build(const key_set<Keys> &keys, float load) {
+	std::unique_ptr<Map> map(new Map);
+	map->max_load_factor(load);
+	for (size_t i = 0; i < keys.stored.size(); ++i) {
+		map->insert(typename Map::value_type(keys.stored[i], static_cast<int>(i)));
+	}
+	return map;
+}
+
+// Benchmarks. Teardown is kept out of the timed region unless it is
+// what is being measured.
+
+template<template<class> class MapOf, class Keys>
+void BM_Insert(benchmark::State &state) {
+	typedef MapOf<Keys> Map;
+	const key_set<Keys> &keys = key_set<Keys>::get(state.range(0));
+	for (auto _ : state) {
+		std::unique_ptr<Map> map = build<Map>(keys, max_load(state));
+		benchmark::DoNotOptimize(map.get());
+		state.PauseTiming();
+		map.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<template<class> class MapOf, class Keys>
+void BM_FindHit(benchmark::State &state) {
+	const key_set<Keys> &keys = key_set<Keys>::get(state.range(0));
+	std::unique_ptr<MapOf<Keys> > map = build<MapOf<Keys> >(keys, max_load(state));
+	size_t i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(map->find(keys.hits[i]));
+		if (++i == keys.hits.size()) {
+			i = 0;
+		}
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+// the hits of BM_FindHit, looked up BATCH at a time through find_batch()
+template<template<class> class MapOf, class Keys>
+void BM_FindBatch(benchmark::State &state) {
+	typedef MapOf<Keys> Map;
+	const size_t BATCH = 64;
+	const key_set<Keys> &keys = key_set<Keys>::get(state.range(0));
+	std::unique_ptr<Map> map = build<Map>(keys, max_load(state));
+	std::vector<typename Map::iterator> found(BATCH);
+	size_t i = 0;
+	for (auto _ : state) {
+		map->find_batch(keys.hits.begin() + i, keys.hits.begin() + i + BATCH, found.begin());
+		benchmark::DoNotOptimize(found.data());
+		i += BATCH;
+		if (i + BATCH > keys.hits.size()) {
+			i = 0;
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * BATCH);
+}
+
+template<template<class> class MapOf, class Keys>
+void BM_FindMiss(benchmark::State &state) {
+	const key_set<Keys> &keys = key_set<Keys>::get(state.range(0));
+	std::unique_ptr<MapOf<Keys> > map = build<MapOf<Keys> >(keys, max_load(state));
+	size_t i = 0;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(map->find(keys.misses[i]));
+		if (++i == keys.misses.size()) {
+			i = 0;
+		}
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+
+template<template<class> class MapOf, class Keys>
+void BM_Erase(benchmark::State &state) {
+	typedef MapOf<Keys> Map;
+	const key_set<Keys> &keys = key_set<Keys>::get(state.range(0));
+	for (auto _ : state) {
+		state.PauseTiming();
+		std::unique_ptr<Map> map = build<Map>(keys, max_load(state));
+		state.ResumeTiming();
+		for (size_t i = 0; i < keys.hits.size(); ++i) {
+			map->erase(map->find(keys.hits[i]));
+		}
+		benchmark::DoNotOptimize(map->size());
+		state.PauseTiming();
+		map.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<template<class> class MapOf, class Keys>
+void BM_Iterate(benchmark::State &state) {
+	const key_set<Keys> &keys = key_set<Keys>::get(state.range(0));
+	std::unique_ptr<MapOf<Keys> > map = build<MapOf<Keys> >(keys, max_load(state));
+	for (auto _ : state) {
+		long long sum = 0;
+		for (auto it = map->begin(); it != map->end(); ++it) {
+			sum += it->second;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// iteration after half of the elements were erased and inserted again
+// in random order, so the insertion list no longer follows memory order
+template<template<class> class MapOf, class Keys>
+void BM_IterateChurned(benchmark::State &state) {
+	typedef MapOf<Keys> Map;
+	const key_set<Keys> &keys = key_set<Keys>::get(state.range(0));
+	std::unique_ptr<Map> map = build<Map>(keys, max_load(state));
+	const size_t half = keys.hits.size() / 2;
+	for (size_t i = 0; i < half; ++i) {
+		map->erase(map->find(keys.hits[i]));
+	}
+	for (size_t i = half; i-- > 0;) {
+		map->insert(typename Map::value_type(keys.hits[i], static_cast<int>(i)));
+	}
+	for (auto _ : state) {
+		long long sum = 0;
+		for (auto it = map->begin(); it != map->end(); ++it) {
+			sum += it->second;
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<template<class> class MapOf, class Keys>
+void BM_Clear(benchmark::State &state) {
+	typedef MapOf<Keys> Map;
+	const key_set<Keys> &keys = key_set<Keys>::get(state.range(0));
+	for (auto _ : state) {
+		state.PauseTiming();
+		std::unique_ptr<Map> map = build<Map>(keys, max_load(state));
+		state.ResumeTiming();
+		map->clear();
+		benchmark::DoNotOptimize(map->size());
+		state.PauseTiming();
+		map.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<template<class> class MapOf, class Keys>
+void BM_Copy(benchmark::State &state) {
+	typedef MapOf<Keys> Map;
+	const key_set<Keys> &keys = key_set<Keys>::get(state.range(0));
+	std::unique_ptr<Map> map = build<Map>(keys, max_load(state));
+	for (auto _ : state) {
+		std::unique_ptr<Map> copy(new Map(*map));
+		benchmark::DoNotOptimize(copy.get());
+		state.PauseTiming();
+		copy.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template<template<class> class MapOf, class Keys>
+void BM_Rehash(benchmark::State &state) {
+	typedef MapOf<Keys> Map;
+	const key_set<Keys> &keys = key_set<Keys>::get(state.range(0));
+	for (auto _ : state) {
+		state.PauseTiming();
+		std::unique_ptr<Map> map = build<Map>(keys, max_load(state));
+		state.ResumeTiming();
+		map->rehash(map->bucket_count() * 2);
+		benchmark::DoNotOptimize(map->bucket_count());
+		state.PauseTiming();
+		map.reset();
+		state.ResumeTiming();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Argument sets: {size, max load factor in percent}.
+
+template<long long MaxSize>
+void sizes(benchmark::internal::Benchmark *b) {
+	for (long long n = 1000; n <= MaxSize; n *= 10) {
+		b->Args({n, 75});
+	}
+}
+
+template<long long MaxSize>
+void sizes_and_loads(benchmark::internal::Benchmark *b) {
+	for (long long n = 1000; n <= MaxSize; n *= 10) {
+		for (long long load : {50, 75, 100}) {
+			b->Args({n, load});
+		}
+	}
+}
+
+} // namespace
+
+#define LINKED_HASHMAP_BENCH_OPS(map, keys, max) \
+	BENCHMARK_TEMPLATE(BM_Insert, map, keys)->Apply(sizes<max>)->Unit(benchmark::kMillisecond); \
+	BENCHMARK_TEMPLATE(BM_FindHit, map, keys)->Apply(sizes_and_loads<max>); \
+	BENCHMARK_TEMPLATE(BM_FindMiss, map, keys)->Apply(sizes_and_loads<max>); \
+	BENCHMARK_TEMPLATE(BM_Erase, map, keys)->Apply(sizes<max>)->Unit(benchmark::kMillisecond); \
+	BENCHMARK_TEMPLATE(BM_Iterate, map, keys)->Apply(sizes<max>)->Unit(benchmark::kMicrosecond); \
+	BENCHMARK_TEMPLATE(BM_IterateChurned, map, keys)->Apply(sizes<max>)->Unit(benchmark::kMicrosecond); \
+	BENCHMARK_TEMPLATE(BM_Clear, map, keys)->Apply(sizes<max>)->Unit(benchmark::kMillisecond); \
+	BENCHMARK_TEMPLATE(BM_Copy, map, keys)->Apply(sizes<max>)->Unit(benchmark::kMillisecond); \
+	BENCHMARK_TEMPLATE(BM_Rehash, map, keys)->Apply(sizes<max>)->Unit(benchmark::kMillisecond)
+
+#define LINKED_HASHMAP_BENCH_MAPS(keys, max) \
+	LINKED_HASHMAP_BENCH_OPS(std_unordered, keys, max); \
+	LINKED_HASHMAP_BENCH_OPS(chained, keys, max); \
+	LINKED_HASHMAP_BENCH_OPS(chained_std_alloc, keys, max); \
+	LINKED_HASHMAP_BENCH_OPS(chained_prime, keys, max); \
+	LINKED_HASHMAP_BENCH_OPS(incremental, keys, max); \
+	LINKED_HASHMAP_BENCH_OPS(robin_hood, keys, max); \
+	LINKED_HASHMAP_BENCH_OPS(swiss, keys, max); \
+	LINKED_HASHMAP_BENCH_OPS(compact, keys, max); \
+	LINKED_HASHMAP_BENCH_OPS(dense, keys, max)
+
+LINKED_HASHMAP_BENCH_MAPS(int_keys, 10000000);
+BENCHMARK_TEMPLATE(BM_FindBatch, chained, int_keys)->Apply(sizes_and_loads<10000000>);
+BENCHMARK_TEMPLATE(BM_FindBatch, incremental, int_keys)->Apply(sizes_and_loads<10000000>);
+BENCHMARK_TEMPLATE(BM_FindBatch, robin_hood, int_keys)->Apply(sizes_and_loads<10000000>);
+BENCHMARK_TEMPLATE(BM_FindBatch, swiss, int_keys)->Apply(sizes_and_loads<10000000>);
+BENCHMARK_TEMPLATE(BM_FindBatch, chained, string_keys)->Apply(sizes_and_loads<1000000>);
+LINKED_HASHMAP_BENCH_MAPS(string_keys, 1000000);
+LINKED_HASHMAP_BENCH_MAPS(integer_keys, 1000000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,819 @@
+/**
+ * a linked_hashmap whose entries link through 32-bit indices
+ */
+#ifndef SJTU_COMPACT_LINKED_HASHMAP_HPP
+#define SJTU_COMPACT_LINKED_HASHMAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <cmath>
+#include "linked_hashmap.hpp"
+
+namespace sjtu {
+    /**
+     * compact_linked_hashmap has the interface and the iteration order of
+     * linked_hashmap, with a denser layout for maps of small elements.
+     *
+     * Entries live in segments of 64, 128, 256, ... slots that never move,
+     * and are named by a 32-bit index. Every link is such an index:
+     *   - the bucket array holds the first entry of each chain;
+     *   - chains are singly linked; erase() finds the predecessor by
+     *     walking the chain of the entry's bucket, which it finds through
+     *     the cached (or recomputed) hash;
+     *   - the insertion order is a doubly linked list of indices.
+     * For a linked_hashmap<int, int> node, 32 bytes of pointers thus
+     * shrink to 12 bytes of links, and the buckets to 4 bytes each.
+     *
+     * Erased slots go on a free list and are reused first, and clear()
+     * keeps the segments for the next fill. Iterators and references stay
+     * valid until their element is erased, as in linked_hashmap. At most
+     * 2^32 - 1 elements fit; inserting beyond that throws runtime_error.
+     *
+     * Since the links are indices, a copy takes over the bucket array and
+     * every link as they are and only copy-constructs the elements.
+     */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>,
+	class Allocator = std::allocator<pair<const Key, T> >,
+	class Indexing = power_of_two_mix
+> class compact_linked_hashmap {
+public:
+	typedef pair<const Key, T> value_type;
+
+private:
+	typedef std::uint32_t link;
+	static const link NIL = 0xffffffffu;
+
+	typedef cache_hash<Key, Hash> hash_cached;
+
+	// a slot: the links, the cached hash (if any) and room for an element
+	struct Entry : node_hash<hash_cached::value> {
+		link next; // next in bucket chain, or next free slot
+		link list_next; // next in insertion order
+		link list_prev; // prev in insertion order
+		alignas(value_type) unsigned char storage[sizeof(value_type)];
+
+		value_type & data() {
+			return *reinterpret_cast<value_type *>(storage);
+		}
+
+		const value_type & data() const {
+			return *reinterpret_cast<const value_type *>(storage);
+		}
+	};
+
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Entry> entry_allocator;
+	typedef std::allocator_traits<entry_allocator> entry_traits;
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<link> link_allocator;
+	typedef std::allocator_traits<link_allocator> link_traits;
+
+	// a move copies the hasher, key_equal and allocators, which the
+	// moved-from map keeps; everything else is only swapped. swap() moves
+	// Hash and Equal through std::swap, and allocators never throw on swap.
+	typedef std::integral_constant<bool, std::is_nothrow_copy_constructible<Hash>::value
+		&& std::is_nothrow_copy_constructible<Equal>::value
+		&& std::is_nothrow_copy_constructible<entry_allocator>::value
+		&& std::is_nothrow_copy_constructible<link_allocator>::value> nothrow_move;
+	typedef std::integral_constant<bool, std::is_nothrow_move_constructible<Hash>::value
+		&& std::is_nothrow_move_assignable<Hash>::value && std::is_nothrow_move_constructible<Equal>::value
+		&& std::is_nothrow_move_assignable<Equal>::value> nothrow_swap;
+
+	// segment s holds FIRST_SEGMENT << s slots, the ones from
+	// (FIRST_SEGMENT << s) - FIRST_SEGMENT on
+	static const size_t FIRST_SEGMENT = 64;
+	static const size_t SEGMENTS = 27; // enough for NIL == 2^32 - 1 slots
+	static const size_t INITIAL_CAPACITY = 16;
+	static const float LOAD_FACTOR;
+
+	Entry* segments[SEGMENTS];
+	size_t segment_total; // segments allocated
+	size_t used; // slots handed out so far, free or not
+	link free_head;
+
+	link* buckets;
+	size_t bucket_total;
+	Indexing bucket_of;
+
+	size_t element_count;
+	float max_load;
+	link head;
+	link tail;
+
+	Hash hasher;
+	Equal key_equal;
+	entry_allocator entry_alloc;
+	link_allocator link_alloc;
+
+	static size_t segment_size(size_t s) {
+		return FIRST_SEGMENT << s;
+	}
+
+	static size_t segment_of(size_t shifted) {
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<size_t>(63 - __builtin_clzll(static_cast<unsigned long long>(shifted))) - 6;
+#else
+		size_t s = 0;
+		while (shifted >= (FIRST_SEGMENT << (s + 1))) {
+			++s;
+		}
+		return s;
+#endif
+	}
+
+	Entry & entry(link id) const {
+		size_t shifted = static_cast<size_t>(id) + FIRST_SEGMENT;
+		size_t s = segment_of(shifted);
+		return segments[s][shifted - segment_size(s)];
+	}
+
+	value_type & value_of(link id) const {
+		return entry(id).data();
+	}
+
+	// Hash helpers, as in linked_hashmap
+	template<class K>
+	size_t hash_key(const K& key) const {
+		return hasher(key);
+	}
+
+	size_t hash_of(const Entry& e) const {
+		return entry_hash_of(e, hash_cached());
+	}
+
+	size_t entry_hash_of(const Entry& e, std::true_type) const {
+		return e.hash;
+	}
+
+	size_t entry_hash_of(const Entry& e, std::false_type) const {
+		return hasher(e.data().first);
+	}
+
+	void store_hash(Entry& e, size_t hash, std::true_type) {
+		e.hash = hash;
+	}
+
+	void store_hash(Entry&, size_t, std::false_type) {}
+
+	bool same_hash(const Entry& e, size_t hash, std::true_type) const {
+		return e.hash == hash;
+	}
+
+	bool same_hash(const Entry&, size_t, std::false_type) const {
+		return true;
+	}
+
+	// Slot management
+	link acquire_slot() {
+		if (free_head != NIL) {
+			link id = free_head;
+			free_head = entry(id).next;
+			return id;
+		}
+		if (used == NIL) {
+			throw runtime_error();
+		}
+		if (used == segment_size(segment_total) - FIRST_SEGMENT) {
+			segments[segment_total] = entry_traits::allocate(entry_alloc, segment_size(segment_total));
+			++segment_total;
+		}
+		return static_cast<link>(used++);
+	}
+
+	void release_slot(link id) {
+		entry(id).next = free_head;
+		free_head = id;
+	}
+
+	void free_segments() {
+		for (size_t s = 0; s < segment_total; ++s) {
+			entry_traits::deallocate(entry_alloc, segments[s], segment_size(s));
+		}
+		segment_total = 0;
+		used = 0;
+		free_head = NIL;
+	}
+
+	void destroy_elements() {
+		if (!std::is_trivially_destructible<value_type>::value) {
+			for (link id = head; id != NIL; id = entry(id).list_next) {
+				value_of(id).~value_type();
+			}
+		}
+	}
+
+	// Buckets
+	void allocate_buckets(size_t n) {
+		bucket_total = Indexing::round(n);
+		buckets = link_traits::allocate(link_alloc, bucket_total);
+		for (size_t i = 0; i < bucket_total; ++i) {
+			buckets[i] = NIL;
+		}
+		bucket_of.resize(bucket_total);
+	}
+
+	// a moved-from map has no buckets
+	void deallocate_buckets(link* old, size_t old_total) {
+		if (old) {
+			link_traits::deallocate(link_alloc, old, old_total);
+		}
+	}
+
+	void rebuild(size_t n) {
+		link* old = buckets;
+		size_t old_total = bucket_total;
+		allocate_buckets(n);
+		deallocate_buckets(old, old_total);
+		for (link id = head; id != NIL; id = entry(id).list_next) {
+			Entry& e = entry(id);
+			link& bucket = buckets[bucket_of(hash_of(e))];
+			e.next = bucket;
+			bucket = id;
+		}
+	}
+
+	size_t buckets_for(size_t n) const {
+		return static_cast<size_t>(std::ceil(n / static_cast<double>(max_load)));
+	}
+
+	size_t load_limit() const {
+		return static_cast<size_t>(bucket_total * max_load);
+	}
+
+	void ensure_capacity() {
+		if (element_count >= load_limit()) {
+			size_t doubled = bucket_total ? bucket_total * 2 : INITIAL_CAPACITY;
+			size_t needed = buckets_for(element_count + 1);
+			rebuild(doubled > needed ? doubled : needed);
+		}
+	}
+
+	template<class K>
+	link find_id(const K& key, size_t hash) const {
+		if (!bucket_total) {
+			return NIL;
+		}
+		for (link id = buckets[bucket_of(hash)]; id != NIL;) {
+			const Entry& e = entry(id);
+			if (same_hash(e, hash, hash_cached()) && key_equal(e.data().first, key)) {
+				return id;
+			}
+			id = e.next;
+		}
+		return NIL;
+	}
+
+	// inserts an element built from args unless key is present, with a
+	// single probe; returns the slot holding key and whether it is new
+	template<class... Args>
+	pair<link, bool> emplace_unique(const Key& key, Args&&... args) {
+		size_t hash = hash_key(key);
+		link existing = find_id(key, hash);
+		if (existing != NIL) {
+			return pair<link, bool>(existing, false);
+		}
+		ensure_capacity();
+		link id = acquire_slot();
+		Entry& e = entry(id);
+		try {
+			::new (static_cast<void *>(e.storage)) value_type(std::forward<Args>(args)...);
+		} catch (...) {
+			release_slot(id);
+			throw;
+		}
+		store_hash(e, hash, hash_cached());
+		link& bucket = buckets[bucket_of(hash)];
+		e.next = bucket;
+		bucket = id;
+		e.list_next = NIL;
+		e.list_prev = tail;
+		if (tail != NIL) {
+			entry(tail).list_next = id;
+		} else {
+			head = id;
+		}
+		tail = id;
+		++element_count;
+		return pair<link, bool>(id, true);
+	}
+
+	void erase_id(link id) {
+		Entry& e = entry(id);
+		link* prev = &buckets[bucket_of(hash_of(e))];
+		while (*prev != id) {
+			prev = &entry(*prev).next;
+		}
+		*prev = e.next;
+		if (e.list_prev != NIL) {
+			entry(e.list_prev).list_next = e.list_next;
+		} else {
+			head = e.list_next;
+		}
+		if (e.list_next != NIL) {
+			entry(e.list_next).list_prev = e.list_prev;
+		} else {
+			tail = e.list_prev;
+		}
+		e.data().~value_type();
+		release_slot(id);
+		--element_count;
+	}
+
+	// takes over the slots, links and buckets of other, an exact image
+	void clone_from(const compact_linked_hashmap& other) {
+		for (size_t s = 0; s < other.segment_total; ++s) {
+			segments[s] = entry_traits::allocate(entry_alloc, segment_size(s));
+			++segment_total;
+		}
+		used = other.used;
+		free_head = other.free_head;
+		for (link id = 0; id < used; ++id) {
+			Entry& e = entry(id);
+			const Entry& o = other.entry(id);
+			e.next = o.next;
+			e.list_next = o.list_next;
+			e.list_prev = o.list_prev;
+			store_hash(e, other.entry_hash_or_zero(o, hash_cached()), hash_cached());
+		}
+		for (size_t i = 0; i < other.bucket_total; ++i) {
+			buckets[i] = other.buckets[i];
+		}
+		link id = other.head;
+		try {
+			for (; id != NIL; id = other.entry(id).list_next) {
+				::new (static_cast<void *>(entry(id).storage)) value_type(other.value_of(id));
+			}
+		} catch (...) {
+			for (link done = other.head; done != id; done = other.entry(done).list_next) {
+				value_of(done).~value_type();
+			}
+			throw;
+		}
+		head = other.head;
+		tail = other.tail;
+		element_count = other.element_count;
+	}
+
+	size_t entry_hash_or_zero(const Entry& e, std::true_type) const {
+		return e.hash;
+	}
+
+	size_t entry_hash_or_zero(const Entry&, std::false_type) const {
+		return 0;
+	}
+
+	void reset_empty() {
+		segment_total = 0;
+		used = 0;
+		free_head = NIL;
+		element_count = 0;
+		head = tail = NIL;
+	}
+
+public:
+	class const_iterator;
+	class iterator {
+	private:
+		link current;
+		compact_linked_hashmap* container;
+
+		friend class compact_linked_hashmap;
+		friend class const_iterator;
+
+		iterator(link current, compact_linked_hashmap* container) : current(current), container(container) {}
+
+	public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = typename compact_linked_hashmap::value_type;
+		using pointer = value_type*;
+		using reference = value_type&;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+		iterator() : current(NIL), container(nullptr) {}
+
+		iterator operator++(int) {
+			iterator temp = *this;
+			++*this;
+			return temp;
+		}
+
+		iterator & operator++() {
+			if (current == NIL) {
+				throw invalid_iterator();
+			}
+			current = container->entry(current).list_next;
+			return *this;
+		}
+
+		iterator operator--(int) {
+			iterator temp = *this;
+			--*this;
+			return temp;
+		}
+
+		iterator & operator--() {
+			if (!container) {
+				throw invalid_iterator();
+			}
+			link prev = current != NIL ? container->entry(current).list_prev : container->tail;
+			if (prev == NIL) {
+				throw invalid_iterator();
+			}
+			current = prev;
+			return *this;
+		}
+
+		value_type & operator*() const {
+			return container->value_of(current);
+		}
+
+		value_type* operator->() const noexcept {
+			return &container->value_of(current);
+		}
+
+		bool operator==(const iterator &rhs) const {
+			return current == rhs.current && container == rhs.container;
+		}
+
+		bool operator==(const const_iterator &rhs) const {
+			return current == rhs.current && container == rhs.container;
+		}
+
+		bool operator!=(const iterator &rhs) const {
+			return !(*this == rhs);
+		}
+
+		bool operator!=(const const_iterator &rhs) const {
+			return !(*this == rhs);
+		}
+	};
+
+	class const_iterator {
+	private:
+		link current;
+		const compact_linked_hashmap* container;
+
+		friend class compact_linked_hashmap;
+		friend class iterator;
+
+		const_iterator(link current, const compact_linked_hashmap* container) : current(current), container(container) {}
+
+	public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = const typename compact_linked_hashmap::value_type;
+		using pointer = value_type*;
+		using reference = value_type&;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+		const_iterator() : current(NIL), container(nullptr) {}
+
+		const_iterator(const iterator &other) : current(other.current), container(other.container) {}
+
+		const_iterator operator++(int) {
+			const_iterator temp = *this;
+			++*this;
+			return temp;
+		}
+
+		const_iterator & operator++() {
+			if (current == NIL) {
+				throw invalid_iterator();
+			}
+			current = container->entry(current).list_next;
+			return *this;
+		}
+
+		const_iterator operator--(int) {
+			const_iterator temp = *this;
+			--*this;
+			return temp;
+		}
+
+		const_iterator & operator--() {
+			if (!container) {
+				throw invalid_iterator();
+			}
+			link prev = current != NIL ? container->entry(current).list_prev : container->tail;
+			if (prev == NIL) {
+				throw invalid_iterator();
+			}
+			current = prev;
+			return *this;
+		}
+
+		const value_type & operator*() const {
+			return container->value_of(current);
+		}
+
+		const value_type* operator->() const noexcept {
+			return &container->value_of(current);
+		}
+
+		bool operator==(const const_iterator &rhs) const {
+			return current == rhs.current && container == rhs.container;
+		}
+
+		bool operator==(const iterator &rhs) const {
+			return current == rhs.current && container == rhs.container;
+		}
+
+		bool operator!=(const const_iterator &rhs) const {
+			return !(*this == rhs);
+		}
+
+		bool operator!=(const iterator &rhs) const {
+			return !(*this == rhs);
+		}
+	};
+
+	compact_linked_hashmap() : compact_linked_hashmap(INITIAL_CAPACITY) {}
+
+	/**
+	 * constructs an empty map with at least bucket_count buckets.
+	 */
+	explicit compact_linked_hashmap(size_t bucket_count, const Hash &hash = Hash(), const Equal &equal = Equal(),
+		const Allocator &allocator = Allocator())
+		: segments(), max_load(LOAD_FACTOR), hasher(hash), key_equal(equal), entry_alloc(allocator), link_alloc(allocator) {
+		reset_empty();
+		allocate_buckets(bucket_count);
+	}
+
+	compact_linked_hashmap(const compact_linked_hashmap &other)
+		: segments(), max_load(other.max_load), hasher(other.hasher), key_equal(other.key_equal),
+		entry_alloc(entry_traits::select_on_container_copy_construction(other.entry_alloc)),
+		link_alloc(link_traits::select_on_container_copy_construction(other.link_alloc)) {
+		reset_empty();
+		allocate_buckets(other.bucket_total);
+		try {
+			clone_from(other);
+		} catch (...) {
+			free_segments();
+			deallocate_buckets(buckets, bucket_total);
+			throw;
+		}
+	}
+
+	/**
+	 * takes over the elements and buckets of other, which is left empty
+	 * with no buckets at all until its next insertion.
+	 */
+	compact_linked_hashmap(compact_linked_hashmap &&other) noexcept(nothrow_move::value)
+		: segments(), buckets(nullptr), bucket_total(0), max_load(other.max_load), hasher(other.hasher),
+		key_equal(other.key_equal), entry_alloc(other.entry_alloc), link_alloc(other.link_alloc) {
+		reset_empty();
+		swap(other);
+	}
+
+	compact_linked_hashmap & operator=(const compact_linked_hashmap &other) {
+		if (this != &other) {
+			compact_linked_hashmap temp(other);
+			swap(temp);
+		}
+		return *this;
+	}
+
+	compact_linked_hashmap & operator=(compact_linked_hashmap &&other) noexcept(nothrow_move::value && nothrow_swap::value) {
+		if (this != &other) {
+			compact_linked_hashmap temp(std::move(other));
+			swap(temp);
+		}
+		return *this;
+	}
+
+	void swap(compact_linked_hashmap &other) noexcept(nothrow_swap::value) {
+		for (size_t s = 0; s < SEGMENTS; ++s) {
+			std::swap(segments[s], other.segments[s]);
+		}
+		std::swap(segment_total, other.segment_total);
+		std::swap(used, other.used);
+		std::swap(free_head, other.free_head);
+		std::swap(buckets, other.buckets);
+		std::swap(bucket_total, other.bucket_total);
+		std::swap(bucket_of, other.bucket_of);
+		std::swap(element_count, other.element_count);
+		std::swap(max_load, other.max_load);
+		std::swap(head, other.head);
+		std::swap(tail, other.tail);
+		std::swap(hasher, other.hasher);
+		std::swap(key_equal, other.key_equal);
+		using std::swap;
+		swap(entry_alloc, other.entry_alloc);
+		swap(link_alloc, other.link_alloc);
+	}
+
+	~compact_linked_hashmap() {
+		destroy_elements();
+		free_segments();
+		deallocate_buckets(buckets, bucket_total);
+	}
+
+	/**
+	 * access specified element with bounds checking.
+	 * throw index_out_of_bound if no such element exists.
+	 */
+	T & at(const Key &key) {
+		link id = find_id(key, hash_key(key));
+		if (id == NIL) {
+			throw index_out_of_bound();
+		}
+		return value_of(id).second;
+	}
+
+	const T & at(const Key &key) const {
+		link id = find_id(key, hash_key(key));
+		if (id == NIL) {
+			throw index_out_of_bound();
+		}
+		return value_of(id).second;
+	}
+
+	/**
+	 * access specified element, inserting a value-initialized one if
+	 * key does not exist.
+	 */
+	T & operator[](const Key &key) {
+		return value_of(emplace_unique(key, std::piecewise_construct,
+			std::forward_as_tuple(key), std::tuple<>()).first).second;
+	}
+
+	/**
+	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 */
+	const T & operator[](const Key &key) const {
+		return at(key);
+	}
+
+	/**
+	 * at() without the exception: a pointer to the value mapped to key,
+	 * or nullptr if there is none.
+	 */
+	T * get(const Key &key) {
+		link id = find_id(key, hash_key(key));
+		return id == NIL ? nullptr : &value_of(id).second;
+	}
+
+	const T * get(const Key &key) const {
+		link id = find_id(key, hash_key(key));
+		return id == NIL ? nullptr : &value_of(id).second;
+	}
+
+	/**
+	 * copies the value mapped to key into out. returns false, leaving out
+	 * alone, if key is not present.
+	 */
+	bool try_get(const Key &key, T &out) const {
+		const T *value = get(key);
+		if (!value) {
+			return false;
+		}
+		out = *value;
+		return true;
+	}
+
+	iterator begin() {
+		return iterator(head, this);
+	}
+
+	const_iterator cbegin() const {
+		return const_iterator(head, this);
+	}
+
+	iterator end() {
+		return iterator(NIL, this);
+	}
+
+	const_iterator cend() const {
+		return const_iterator(NIL, this);
+	}
+
+	bool empty() const {
+		return element_count == 0;
+	}
+
+	size_t size() const {
+		return element_count;
+	}
+
+	size_t bucket_count() const {
+		return bucket_total;
+	}
+
+	float load_factor() const {
+		if (!bucket_total) {
+			return 0;
+		}
+		return static_cast<float>(element_count) / bucket_total;
+	}
+
+	float max_load_factor() const {
+		return max_load;
+	}
+
+	/**
+	 * throw runtime_error unless ml > 0
+	 */
+	void max_load_factor(float ml) {
+		if (!(ml > 0)) {
+			throw runtime_error();
+		}
+		max_load = ml;
+		if (element_count > load_limit()) {
+			rebuild(buckets_for(element_count));
+		}
+	}
+
+	void rehash(size_t count) {
+		size_t needed = buckets_for(element_count);
+		rebuild(count > needed ? count : needed);
+	}
+
+	void reserve(size_t count) {
+		if (count > load_limit()) {
+			rebuild(buckets_for(count));
+		}
+	}
+
+	/**
+	 * clears the contents; the slot segments are kept for reuse.
+	 */
+	void clear() {
+		destroy_elements();
+		used = 0;
+		free_head = NIL;
+		element_count = 0;
+		head = tail = NIL;
+		for (size_t i = 0; i < bucket_total; ++i) {
+			buckets[i] = NIL;
+		}
+	}
+
+	pair<iterator, bool> insert(const value_type &value) {
+		pair<link, bool> result = emplace_unique(value.first, value);
+		return pair<iterator, bool>(iterator(result.first, this), result.second);
+	}
+
+	pair<iterator, bool> insert(value_type &&value) {
+		pair<link, bool> result = emplace_unique(value.first, std::move(value));
+		return pair<iterator, bool>(iterator(result.first, this), result.second);
+	}
+
+	template<class... Args>
+	pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+		pair<link, bool> result = emplace_unique(key, std::piecewise_construct,
+			std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		return pair<iterator, bool>(iterator(result.first, this), result.second);
+	}
+
+	template<class M>
+	pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+		pair<iterator, bool> result = try_emplace(key, std::forward<M>(obj));
+		if (!result.second) {
+			result.first->second = std::forward<M>(obj);
+		}
+		return result;
+	}
+
+	/**
+	 * throw invalid_iterator if pos is end() or belongs to another map
+	 */
+	void erase(iterator pos) {
+		if (pos.container != this || pos.current == NIL) {
+			throw invalid_iterator();
+		}
+		erase_id(pos.current);
+	}
+
+	size_t erase(const Key &key) {
+		link id = find_id(key, hash_key(key));
+		if (id == NIL) {
+			return 0;
+		}
+		erase_id(id);
+		return 1;
+	}
+
+	size_t count(const Key &key) const {
+		return find_id(key, hash_key(key)) != NIL ? 1 : 0;
+	}
+
+	iterator find(const Key &key) {
+		return iterator(find_id(key, hash_key(key)), this);
+	}
+
+	const_iterator find(const Key &key) const {
+		return const_iterator(find_id(key, hash_key(key)), this);
+	}
+};
+
+template<class Key, class T, class Hash, class Equal, class Allocator, class Indexing>
+const float compact_linked_hashmap<Key, T, Hash, Equal, Allocator, Indexing>::LOAD_FACTOR = 0.75f;
+
+}
+
+#endif
@@ -0,0 +1,324 @@
+/**
+ * a sharded, thread-safe wrapper around sjtu::linked_hashmap
+ */
+#ifndef SJTU_CONCURRENT_LINKED_HASHMAP_HPP
+#define SJTU_CONCURRENT_LINKED_HASHMAP_HPP
+
+#include <algorithm>
+#include <functional>
+#include <cstddef>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <shared_mutex>
+#include "linked_hashmap.hpp"
+
+namespace sjtu {
+    /**
+     * concurrent_linked_hashmap splits the key space into shard_count()
+     * shards, each a linked_hashmap behind its own reader-writer lock.
+     * Lookups take the shard's lock shared and updates take it exclusive,
+     * so threads working on different shards never touch the same lock,
+     * and readers of one shard do not block each other.
+     *
+     * Since a reference into a shard would outlive its lock, the
+     * interface hands out copies (find) or runs a callback while the lock
+     * is held (visit, modify, for_each). Callbacks must not call back
+     * into the same map.
+     *
+     * Every insertion draws a number from a global sequence. for_each()
+     * walks shard by shard, each in its own insertion order;
+     * for_each_ordered() locks all shards and merges them into the global
+     * insertion order. As in linked_hashmap, re-inserting a present key
+     * keeps its place.
+     */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>,
+	class Allocator = pool_allocator<pair<const Key, T> >,
+	class Engine = SJTU_LINKED_HASHMAP_DEFAULT_ENGINE
+> class concurrent_linked_hashmap {
+public:
+	typedef pair<const Key, T> value_type;
+
+private:
+#if __cplusplus >= 201703L
+	typedef std::shared_mutex lock_type;
+#else
+	typedef std::shared_timed_mutex lock_type;
+#endif
+	typedef std::unique_lock<lock_type> write_lock;
+	typedef std::shared_lock<lock_type> read_lock;
+
+	// the mapped value together with the insertion sequence number
+	struct entry {
+		unsigned long long seq;
+		T value;
+
+		template<class... Args>
+		explicit entry(unsigned long long seq, Args&&... args) : seq(seq), value(std::forward<Args>(args)...) {}
+	};
+
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<pair<const Key, entry> > entry_allocator;
+	typedef linked_hashmap<Key, entry, Hash, Equal, entry_allocator, Engine> map_type;
+
+	// one cache line per shard at least, so that the locks of neighbouring
+	// shards do not share a line
+	struct alignas(64) shard {
+		mutable lock_type lock;
+		map_type map;
+
+		explicit shard(const Hash &hash) : map(0, hash) {}
+	};
+
+	static const size_t DEFAULT_SHARDS = 16;
+
+	// the shards are built in place in storage, each from the given hash
+	std::unique_ptr<unsigned char[]> storage;
+	shard *shards;
+	size_t shard_total; // a power of two
+	unsigned int shift;
+	Hash hasher;
+	std::atomic<unsigned long long> next_seq;
+
+	// a multiplier other than the one of power_of_two_mix, so the shard
+	// does not fix the bits that pick a bucket inside the shard
+	shard &shard_of(const Key &key) const {
+		if (shard_total == 1) {
+			return shards[0];
+		}
+		size_t mixed = static_cast<size_t>(static_cast<unsigned long long>(hasher(key)) * 0xff51afd7ed558ccdull);
+		return shards[mixed >> shift];
+	}
+
+public:
+	/**
+	 * an empty map with at least shard_count shards, rounded up to a
+	 * power of two.
+	 */
+	explicit concurrent_linked_hashmap(size_t shard_count = DEFAULT_SHARDS, const Hash &hash = Hash())
+		: shard_total(1), shift(sizeof(size_t) * 8), hasher(hash), next_seq(0) {
+		while (shard_total < shard_count) {
+			shard_total <<= 1;
+			--shift;
+		}
+		size_t bytes = shard_total * sizeof(shard);
+		size_t space = bytes + alignof(shard) - 1;
+		storage.reset(new unsigned char[space]);
+		void *raw = storage.get();
+		shards = static_cast<shard *>(std::align(alignof(shard), bytes, raw, space));
+		size_t built = 0;
+		try {
+			for (; built < shard_total; ++built) {
+				::new (static_cast<void *>(shards + built)) shard(hash);
+			}
+		} catch (...) {
+			while (built) {
+				shards[--built].~shard();
+			}
+			throw;
+		}
+	}
+
+	concurrent_linked_hashmap(const concurrent_linked_hashmap &) = delete;
+	concurrent_linked_hashmap & operator=(const concurrent_linked_hashmap &) = delete;
+
+	~concurrent_linked_hashmap() {
+		for (size_t i = 0; i < shard_total; ++i) {
+			shards[i].~shard();
+		}
+	}
+
+	size_t shard_count() const {
+		return shard_total;
+	}
+
+	/**
+	 * the number of elements. Shards are counted one after another, so
+	 * under concurrent updates this is only a snapshot.
+	 */
+	size_t size() const {
+		size_t total = 0;
+		for (size_t i = 0; i < shard_total; ++i) {
+			read_lock guard(shards[i].lock);
+			total += shards[i].map.size();
+		}
+		return total;
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	size_t count(const Key &key) const {
+		shard &s = shard_of(key);
+		read_lock guard(s.lock);
+		return s.map.count(key);
+	}
+
+	bool contains(const Key &key) const {
+		return count(key) != 0;
+	}
+
+	/**
+	 * copies the value of key into out. returns false, leaving out
+	 * alone, if key is not present.
+	 */
+	bool find(const Key &key, T &out) const {
+		shard &s = shard_of(key);
+		read_lock guard(s.lock);
+		typename map_type::const_iterator it = s.map.find(key);
+		if (it == s.map.cend()) {
+			return false;
+		}
+		out = it->second.value;
+		return true;
+	}
+
+	/**
+	 * calls f(const T &) on the value of key under the shard's shared
+	 * lock. returns whether key was present.
+	 */
+	template<class F>
+	bool visit(const Key &key, F f) const {
+		shard &s = shard_of(key);
+		read_lock guard(s.lock);
+		typename map_type::const_iterator it = s.map.find(key);
+		if (it == s.map.cend()) {
+			return false;
+		}
+		f(it->second.value);
+		return true;
+	}
+
+	/**
+	 * calls f(T &) on the value of key under the shard's exclusive lock.
+	 * returns whether key was present.
+	 */
+	template<class F>
+	bool modify(const Key &key, F f) {
+		shard &s = shard_of(key);
+		write_lock guard(s.lock);
+		typename map_type::iterator it = s.map.find(key);
+		if (it == s.map.end()) {
+			return false;
+		}
+		f(it->second.value);
+		return true;
+	}
+
+	/**
+	 * inserts value unless its key is present.
+	 * returns whether it was inserted.
+	 */
+	bool insert(const value_type &value) {
+		return try_emplace(value.first, value.second);
+	}
+
+	template<class... Args>
+	bool try_emplace(const Key &key, Args&&... args) {
+		shard &s = shard_of(key);
+		write_lock guard(s.lock);
+		// a number drawn for a present key is simply skipped
+		return s.map.try_emplace(key, next_seq.fetch_add(1, std::memory_order_relaxed),
+			std::forward<Args>(args)...).second;
+	}
+
+	/**
+	 * stores obj under key, replacing the value of a present key.
+	 * returns whether key was new.
+	 */
+	template<class M>
+	bool insert_or_assign(const Key &key, M &&obj) {
+		shard &s = shard_of(key);
+		write_lock guard(s.lock);
+		// try_emplace leaves obj alone when key is present
+		pair<typename map_type::iterator, bool> result =
+			s.map.try_emplace(key, next_seq.fetch_add(1, std::memory_order_relaxed), std::forward<M>(obj));
+		if (!result.second) {
+			result.first->second.value = std::forward<M>(obj);
+		}
+		return result.second;
+	}
+
+	size_t erase(const Key &key) {
+		shard &s = shard_of(key);
+		write_lock guard(s.lock);
+		return s.map.erase(key);
+	}
+
+	void clear() {
+		for (size_t i = 0; i < shard_total; ++i) {
+			write_lock guard(shards[i].lock);
+			shards[i].map.clear();
+		}
+	}
+
+	/**
+	 * calls f(const Key &, const T &) on every element, one shard at a
+	 * time under its shared lock, each shard in insertion order.
+	 */
+	template<class F>
+	void for_each(F f) const {
+		for (size_t i = 0; i < shard_total; ++i) {
+			for_each_in_shard(i, f);
+		}
+	}
+
+	template<class F>
+	void for_each_in_shard(size_t index, F f) const {
+		read_lock guard(shards[index].lock);
+		const map_type &map = shards[index].map;
+		for (typename map_type::const_iterator it = map.cbegin(); it != map.cend(); ++it) {
+			f(it->first, it->second.value);
+		}
+	}
+
+	/**
+	 * calls f(const Key &, const T &) on every element in global
+	 * insertion order. All shards are locked shared for the whole walk,
+	 * which blocks every writer until it ends. The shards are merged
+	 * through a heap of their cursors, in O(n log shard_count()).
+	 */
+	template<class F>
+	void for_each_ordered(F f) const {
+		std::unique_ptr<read_lock[]> guards(new read_lock[shard_total]);
+		std::unique_ptr<typename map_type::const_iterator[]> at(new typename map_type::const_iterator[shard_total]);
+		// shards are locked in index order, the only order anyone locks
+		// more than one of them in
+		for (size_t i = 0; i < shard_total; ++i) {
+			guards[i] = read_lock(shards[i].lock);
+			at[i] = shards[i].map.cbegin();
+		}
+		// each shard is already sorted by sequence number: merge them,
+		// keeping the non-empty shards in a heap with the smallest
+		// sequence number on top
+		std::unique_ptr<size_t[]> heap(new size_t[shard_total]);
+		size_t live = 0;
+		for (size_t i = 0; i < shard_total; ++i) {
+			if (at[i] != shards[i].map.cend()) {
+				heap[live++] = i;
+			}
+		}
+		typename map_type::const_iterator *cursor = at.get();
+		auto later = [cursor](size_t a, size_t b) { return cursor[a]->second.seq > cursor[b]->second.seq; };
+		std::make_heap(heap.get(), heap.get() + live, later);
+		while (live > 0) {
+			std::pop_heap(heap.get(), heap.get() + live, later);
+			size_t next = heap[live - 1];
+			f(at[next]->first, at[next]->second.value);
+			if (++at[next] == shards[next].map.cend()) {
+				--live;
+			} else {
+				std::push_heap(heap.get(), heap.get() + live, later);
+			}
+		}
+	}
+};
+
+}
+
+#endif
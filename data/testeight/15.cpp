@@ -0,0 +1,107 @@
+#include "lru_cache.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+
+std::vector<int> evicted;
+
+//	counts its calls, to show that every access hashes the key once
+static size_t hash_calls = 0;
+
+struct counted_hash {
+	size_t operator()(int key) const {
+		++hash_calls;
+		return std::hash<int>()(key);
+	}
+};
+
+void record(sjtu::pair<const int, std::string> &entry) {
+	evicted.push_back(entry.first);
+}
+
+void print_order(sjtu::lru_cache<int, std::string> &cache) {
+	for (auto it = cache.begin(); it != cache.end(); ++it) {
+		std::cout << it->first << " ";
+	}
+	std::cout << std::endl;
+}
+
+void tester(void) {
+	sjtu::lru_cache<int, std::string> cache(4, record);
+	//	test: inserts beyond the capacity evict the oldest entries
+	for (int i = 0; i < 6; ++i) {
+		cache.insert(sjtu::pair<const int, std::string>(i, std::to_string(i)));
+	}
+	print_order(cache);
+	//	test: a hit moves the entry to the back, a peek does not
+	std::cout << cache.find(2)->second << " " << cache.peek(3)->second << " " << (cache.find(0) == cache.end()) << std::endl;
+	print_order(cache);
+	//	test: the touched entry survives the next eviction
+	cache.try_emplace(6, "6");
+	cache.insert_or_assign(2, std::string("two"));
+	cache.insert_or_assign(7, std::string("7"));
+	print_order(cache);
+	std::cout << cache.at(2) << " " << cache.size() << " " << cache.capacity() << std::endl;
+	//	test: shrinking the capacity evicts, pop_front and erase do not report
+	cache.set_capacity(2);
+	print_order(cache);
+	cache.pop_front();
+	cache.erase(2);
+	std::cout << cache.empty() << " ";
+	for (size_t i = 0; i < evicted.size(); ++i) {
+		std::cout << evicted[i] << " ";
+	}
+	std::cout << std::endl;
+	//	test: exceptions
+	try {
+		cache.pop_front();
+	} catch (sjtu::container_is_empty &) {
+		std::cout << "empty ";
+	}
+	try {
+		cache.at(100);
+	} catch (sjtu::index_out_of_bound &) {
+		std::cout << "missing ";
+	}
+	try {
+		sjtu::lru_cache<int, std::string> none(0);
+	} catch (sjtu::runtime_error &) {
+		std::cout << "zero";
+	}
+	std::cout << std::endl;
+	//	test: an entry that keeps being hit outlives a long run of inserts
+	sjtu::lru_cache<int, int> big(1000);
+	for (int i = 0; i < 100000; ++i) {
+		big.insert(sjtu::pair<const int, int>(i, i));
+		assert(big.find(0) != big.end());
+	}
+	int expected = 99001;
+	bool ordered = true;
+	for (auto it = big.cbegin(); it != --big.end(); ++it) {
+		ordered = ordered && it->first == expected++;
+	}
+	std::cout << big.size() << " " << ordered << " " << (--big.end())->first << " " << big.count(99000) << std::endl;
+	//	test: a hit or a miss on a full cache hashes the key only once
+	sjtu::lru_cache<int, int, counted_hash> counted(100);
+	for (int i = 0; i < 100; ++i) {
+		counted.try_emplace(i, i);
+	}
+	size_t calls[4];
+	hash_calls = 0;
+	bool hit = !counted.try_emplace(50, -1).second;
+	calls[0] = hash_calls;
+	bool missed = counted.try_emplace(100, 100).second;
+	calls[1] = hash_calls - calls[0];
+	bool assigned = !counted.insert_or_assign(100, -100).second;
+	calls[2] = hash_calls - calls[0] - calls[1];
+	bool replaced = counted.insert_or_assign(101, 101).second;
+	calls[3] = hash_calls - calls[0] - calls[1] - calls[2];
+	std::cout << hit << missed << assigned << replaced << " " << calls[0] << calls[1] << calls[2] << calls[3] << " "
+		<< counted.peek(50)->second << " " << counted.peek(100)->second << " " << counted.size() << " " << counted.begin()->first
+		<< " " << (--counted.end())->first << std::endl;
+}
+
+int main(void) {
+	tester();
+}
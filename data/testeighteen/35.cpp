@@ -0,0 +1,79 @@
+#include "linked_hashmap.hpp"
+#include "compact_linked_hashmap.hpp"
+#include "dense_linked_hashmap.hpp"
+#include "lru_cache.hpp"
+#include "mapped_linked_hashmap.hpp"
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+struct alignas(64) block {
+	char bytes[64];
+};
+
+template<class Map>
+void check(Map &map, const char *name) {
+	for (int i = 0; i < 100; ++i) {
+		map[i] = "value" + std::to_string(i);
+	}
+	const Map &read = map;
+	std::string out = "untouched";
+	bool hit = read.try_get(42, out);
+	bool miss = read.try_get(420, out);
+	std::cout << name << " " << *map.get(7) << " " << *read.get(99) << " " << (map.get(100) == nullptr) << " "
+		<< (read.get(-1) == nullptr) << " " << hit << miss << " " << out << " ";
+	*map.get(7) = "changed";
+	std::cout << map.at(7) << " " << (map.get(7) == &map.at(7)) << std::endl;
+}
+
+void tester(void) {
+	sjtu::linked_hashmap<int, std::string> linked;
+	check(linked, "linked");
+	sjtu::compact_linked_hashmap<int, std::string> compact;
+	check(compact, "compact");
+	sjtu::dense_linked_hashmap<int, std::string> dense;
+	check(dense, "dense");
+	//	test: heterogeneous get()
+	sjtu::linked_hashmap<std::string, int, sjtu::string_hash, std::equal_to<> > words;
+	words["alpha"] = 1;
+	words["beta"] = 2;
+	int beta = 0;
+	std::cout << *words.get("alpha") << " " << (words.get(std::string_view("gamma")) == nullptr) << " "
+		<< words.try_get("beta", beta) << beta << std::endl;
+	//	test: a cache hit through get() touches the entry
+	sjtu::lru_cache<int, int> cache(3);
+	cache.insert(sjtu::pair<const int, int>(1, 10));
+	cache.insert(sjtu::pair<const int, int>(2, 20));
+	cache.insert(sjtu::pair<const int, int>(3, 30));
+	std::cout << *cache.get(1) << " " << (cache.get(4) == nullptr) << " ";
+	cache.insert(sjtu::pair<const int, int>(4, 40));
+	std::cout << cache.count(1) << cache.count(2) << std::endl;
+	//	test: a mapped snapshot answers without throwing
+	sjtu::linked_hashmap<int, int> numbers;
+	for (int i = 0; i < 10; ++i) {
+		numbers[i] = i * i;
+	}
+	std::stringstream stream;
+	sjtu::save(numbers, stream);
+	std::string image = stream.str();
+	std::unique_ptr<block[]> buffer(new block[image.size() / sizeof(block) + 1]);
+	std::memcpy(buffer.get(), image.data(), image.size());
+	sjtu::mapped_linked_hashmap<int, int> mapped(buffer.get(), image.size());
+	int nine = 0;
+	std::cout << *mapped.get(3) << " " << (mapped.get(10) == nullptr) << " " << mapped.try_get(9, nine) << nine << std::endl;
+	//	test: exceptions are cheap to make and copy, and still describe themselves
+	try {
+		linked.at(-5);
+	} catch (sjtu::index_out_of_bound &error) {
+		sjtu::exception copy(error);
+		std::cout << "[" << copy.what() << "] " << std::is_nothrow_copy_constructible<sjtu::exception>::value
+			<< std::is_nothrow_default_constructible<sjtu::index_out_of_bound>::value << std::endl;
+	}
+}
+
+int main(void) {
+	tester();
+}
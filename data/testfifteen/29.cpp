@@ -0,0 +1,118 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <atomic>
+#include <vector>
+#include <string>
+
+typedef sjtu::pair<const int, std::string> value_type;
+typedef sjtu::linked_hashmap<int, std::string> map_type;
+
+//	a value whose copies throw once the countdown runs out
+struct fragile {
+	static std::atomic<int> countdown;
+	int value;
+
+	fragile(int value) : value(value) {}
+	fragile(const fragile &other) : value(other.value) {
+		if (--countdown == 0) {
+			throw sjtu::runtime_error();
+		}
+	}
+};
+
+std::atomic<int> fragile::countdown(0);
+
+bool same(const map_type &lhs, const map_type &rhs) {
+	if (lhs.size() != rhs.size()) {
+		return false;
+	}
+	auto it = lhs.cbegin();
+	for (auto ref = rhs.cbegin(); ref != rhs.cend(); ++ref, ++it) {
+		if (it->first != ref->first || it->second != ref->second) {
+			return false;
+		}
+	}
+	return it == lhs.cend() && lhs.count(-5) == 0 && lhs.at(rhs.cbegin()->first) == rhs.cbegin()->second;
+}
+
+void tester(void) {
+	std::vector<value_type> input;
+	for (int i = 0; i < 60000; ++i) {
+		int key = i * 7919 % 40009;
+		input.push_back(value_type(key, std::to_string(i)));
+	}
+	//	test: any number of threads builds the map insert() builds
+	map_type serial;
+	serial.insert(input.begin(), input.end());
+	std::cout << serial.size();
+	for (size_t threads : {1, 2, 4, 7, 0}) {
+		map_type parallel(input.begin(), input.end(), threads);
+		std::cout << " " << same(parallel, serial);
+	}
+	map_type grown;
+	grown[3] = "three";
+	grown[-1] = "first";
+	grown.parallel_insert(input.begin(), input.begin() + 30000, 3);
+	grown.parallel_insert(input.begin() + 30000, input.end(), 5);
+	std::cout << " " << grown.size() << " " << grown.cbegin()->second << " " << grown.at(3) << std::endl;
+	//	test: parallel iteration reaches every element once
+	std::atomic<long long> sum(0);
+	std::atomic<int> visited(0);
+	serial.parallel_for_each(4, [&sum, &visited](value_type &v) {
+		sum += v.first;
+		++visited;
+		v.second += "!";
+	});
+	long long expected = 0;
+	for (auto it = serial.cbegin(); it != serial.cend(); ++it) {
+		expected += it->first;
+	}
+	const map_type &view = serial;
+	std::atomic<int> marked(0);
+	view.parallel_for_each(0, [&marked](const value_type &v) {
+		if (v.second.back() == '!') {
+			++marked;
+		}
+	});
+	map_type tiny;
+	tiny[1] = "one";
+	tiny.parallel_for_each(16, [&visited](value_type &) {
+		++visited;
+	});
+	map_type().parallel_for_each(4, [&visited](value_type &) {
+		++visited;
+	});
+	std::cout << (sum == expected) << " " << visited << " " << marked << std::endl;
+	//	test: exceptions come back, and a failed build changes nothing
+	int caught = 0;
+	try {
+		serial.parallel_for_each(3, [](value_type &v) {
+			if (v.first == 40008) {
+				throw sjtu::index_out_of_bound();
+			}
+		});
+	} catch (sjtu::index_out_of_bound &) {
+		++caught;
+	}
+	std::vector<sjtu::pair<const int, fragile> > pieces;
+	for (int i = 0; i < 1000; ++i) {
+		pieces.push_back(sjtu::pair<const int, fragile>(i % 700, fragile(i)));
+	}
+	sjtu::linked_hashmap<int, fragile> target;
+	target.insert(sjtu::pair<const int, fragile>(5, fragile(-5)));
+	fragile::countdown = 900;
+	try {
+		target.parallel_insert(pieces.begin(), pieces.end(), 4);
+	} catch (sjtu::runtime_error &) {
+		++caught;
+	}
+	std::cout << caught << " " << target.size() << " " << target.at(5).value << " " << target.count(6) << std::endl;
+	fragile::countdown = 0;
+	target.parallel_insert(pieces.begin(), pieces.end(), 4);
+	std::cout << target.size() << " " << target.at(5).value << " " << target.at(699).value << " "
+		<< (--target.end())->second.value << std::endl;
+}
+
+int main(void) {
+	tester();
+}
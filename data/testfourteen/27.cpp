@@ -0,0 +1,141 @@
+#include "mapped_linked_hashmap.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <memory>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+struct point {
+	int x, y;
+};
+
+typedef sjtu::linked_hashmap<long long, point> map_type;
+typedef sjtu::mapped_linked_hashmap<long long, point> view_type;
+
+struct alignas(64) block {
+	char bytes[64];
+};
+
+//	the view and the map must hold the same elements in the same order
+template<class View>
+bool same(const View &view, const map_type &map) {
+	if (view.size() != map.size()) {
+		return false;
+	}
+	auto it = view.cbegin();
+	for (auto ref = map.cbegin(); ref != map.cend(); ++ref, ++it) {
+		if (it->first != ref->first || it->second.x != ref->second.x || !view.count(ref->first)
+			|| view.find(ref->first) != it || view.at(ref->first).y != ref->second.y) {
+			return false;
+		}
+	}
+	return it == view.cend();
+}
+
+void tester(void) {
+	map_type map;
+	for (long long i = 0; i < 50000; ++i) {
+		long long key = i * 7919 % 100003;
+		point p = {static_cast<int>(i), static_cast<int>(key % 13)};
+		map.insert(sjtu::pair<const long long, point>(key, p));
+	}
+	for (long long i = 0; i < 50000; i += 3) {
+		map.erase(i * 7919 % 100003);
+	}
+	//	test: save and load through a stream
+	std::stringstream stream;
+	sjtu::save(map, stream);
+	stream << "tail";
+	map_type loaded;
+	loaded[1].x = 5;
+	sjtu::load(loaded, stream);
+	std::string rest;
+	stream >> rest;
+	bool ok = loaded.size() == map.size();
+	auto l = loaded.cbegin();
+	for (auto it = map.cbegin(); ok && it != map.cend(); ++it, ++l) {
+		ok = it->first == l->first && it->second.x == l->second.x && it->second.y == l->second.y;
+	}
+	std::cout << ok << " " << loaded.size() << " " << rest << std::endl;
+	//	test: a view of the image in memory
+	std::string image = stream.str().substr(0, stream.str().size() - 4);
+	std::unique_ptr<block[]> buffer(new block[image.size() / sizeof(block) + 1]);
+	std::memcpy(buffer.get(), image.data(), image.size());
+	view_type memory(buffer.get(), image.size());
+	std::cout << same(memory, map) << " " << memory.count(3) << " " << (memory.find(3) == memory.end())
+		<< " " << (memory.bucket_count() >= memory.size()) << std::endl;
+	//	test: save to a file and map it
+	std::string path = "/tmp/linked_hashmap_snapshot_" + std::to_string(getpid()) + ".bin";
+	int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+	sjtu::save(map, fd);
+	close(fd);
+	{
+		view_type mapped(path.c_str());
+		view_type moved(std::move(mapped));
+		std::cout << same(moved, map) << " " << mapped.size() << " " << (mapped.begin() == mapped.end()) << " "
+			<< (--moved.cend())->first << std::endl;
+		fd = open(path.c_str(), O_RDONLY);
+		map_type again;
+		sjtu::load(again, fd);
+		close(fd);
+		std::cout << again.size() << " " << again.cbegin()->first << std::endl;
+	}
+	unlink(path.c_str());
+	//	test: empty maps, and what is not a snapshot
+	map_type empty;
+	std::stringstream nothing;
+	sjtu::save(empty, nothing);
+	std::string blank = nothing.str();
+	std::memcpy(buffer.get(), blank.data(), blank.size());
+	view_type none(buffer.get(), blank.size());
+	std::cout << none.size() << " " << none.empty() << " " << none.count(1) << " " << (none.begin() == none.end()) << std::endl;
+	int caught = 0;
+	try {
+		none.at(1);
+	} catch (sjtu::index_out_of_bound &) {
+		++caught;
+	}
+	try {
+		++none.end();
+	} catch (sjtu::invalid_iterator &) {
+		++caught;
+	}
+	try {
+		view_type truncated(buffer.get(), blank.size() - 8);
+	} catch (sjtu::runtime_error &) {
+		++caught;
+	}
+	buffer[0].bytes[0] = 'X';
+	try {
+		view_type corrupt(buffer.get(), blank.size());
+	} catch (sjtu::runtime_error &) {
+		++caught;
+	}
+	try {
+		std::stringstream wrong(image.substr(0, image.size() / 2));
+		sjtu::load(empty, wrong);
+	} catch (sjtu::runtime_error &) {
+		++caught;
+	}
+	try {
+		std::stringstream other;
+		sjtu::linked_hashmap<int, int> small;
+		small[1] = 1;
+		sjtu::save(small, other);
+		sjtu::load(empty, other);
+	} catch (sjtu::runtime_error &) {
+		++caught;
+	}
+	try {
+		view_type missing("/nonexistent/snapshot.bin");
+	} catch (sjtu::runtime_error &) {
+		++caught;
+	}
+	std::cout << caught << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,118 @@
+#include "concurrent_linked_hashmap.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int THREADS = 4;
+const int PER_THREAD = 20000;
+
+//	a hash with state and no default constructor, counting its calls
+struct counting_hash {
+	size_t *calls;
+
+	explicit counting_hash(size_t *calls) : calls(calls) {}
+
+	size_t operator()(int key) const {
+		++*calls;
+		return static_cast<size_t>(key);
+	}
+};
+
+void tester(void) {
+	sjtu::concurrent_linked_hashmap<int, std::string> map(8);
+	std::cout << map.shard_count() << " " << sjtu::concurrent_linked_hashmap<int, int>(5).shard_count() << std::endl;
+	//	test: writers on disjoint keys, readers on everything
+	std::vector<std::thread> workers;
+	for (int t = 0; t < THREADS; ++t) {
+		workers.push_back(std::thread([&map, t]() {
+			for (int i = t * PER_THREAD; i < (t + 1) * PER_THREAD; ++i) {
+				assert(map.insert(sjtu::pair<const int, std::string>(i, std::to_string(i))));
+				assert(!map.try_emplace(i, "again"));
+				if (i % 3 == 0) {
+					assert(map.erase(i) == 1);
+				}
+			}
+		}));
+		workers.push_back(std::thread([&map]() {
+			std::string value;
+			for (int i = 0; i < THREADS * PER_THREAD; ++i) {
+				if (map.find(i, value)) {
+					assert(value == std::to_string(i));
+				}
+			}
+		}));
+	}
+	for (size_t i = 0; i < workers.size(); ++i) {
+		workers[i].join();
+	}
+	int present = 0;
+	for (int i = 0; i < THREADS * PER_THREAD; ++i) {
+		present += map.contains(i);
+		assert(map.count(i) == (i % 3 != 0));
+	}
+	std::cout << map.size() << " " << present << std::endl;
+	//	test: modify and visit
+	map.modify(1, [](std::string &value) { value += "!"; });
+	bool seen = map.visit(1, [](const std::string &value) { std::cout << value << " "; });
+	std::cout << seen << " " << map.visit(3, [](const std::string &) {}) << std::endl;
+	//	test: global insertion order across shards
+	sjtu::concurrent_linked_hashmap<int, int> ordered(4);
+	for (int i = 0; i < 1000; ++i) {
+		ordered.insert(sjtu::pair<const int, int>((i * 7919) % 1000, i));
+	}
+	ordered.erase(0);
+	ordered.insert_or_assign(7919 % 1000, -1);
+	ordered.insert_or_assign(0, 1000);
+	//	the value of a key is its insertion rank, except for the reassigned 919
+	std::vector<int> values;
+	ordered.for_each_ordered([&values](const int &, const int &value) {
+		values.push_back(value);
+	});
+	bool in_order = values.size() == 1000 && values[0] == -1;
+	for (size_t i = 1; i < values.size(); ++i) {
+		in_order = in_order && values[i] == static_cast<int>(i) + 1;
+	}
+	//	per shard, the values only have to increase
+	bool shard_order = true;
+	for (size_t i = 0; i < ordered.shard_count(); ++i) {
+		int last = -1;
+		ordered.for_each_in_shard(i, [&](const int &, const int &value) {
+			shard_order = shard_order && (value == -1 || value > last);
+			last = value;
+		});
+	}
+	std::cout << in_order << " " << shard_order << " " << ordered.size() << std::endl;
+	size_t total = 0;
+	for (size_t i = 0; i < ordered.shard_count(); ++i) {
+		ordered.for_each_in_shard(i, [&](const int &, const int &) { ++total; });
+	}
+	ordered.clear();
+	std::cout << total << " " << ordered.empty() << std::endl;
+	//	test: the merge skips empty shards, here most of 64, and empty maps
+	sjtu::concurrent_linked_hashmap<int, int> wide(64);
+	size_t calls = 0;
+	wide.for_each_ordered([&calls](const int &, const int &) { ++calls; });
+	for (int i = 0; i < 20; ++i) {
+		wide.insert(sjtu::pair<const int, int>(1000 - i * 37, i));
+	}
+	int rank = 0;
+	bool wide_order = true;
+	wide.for_each_ordered([&](const int &key, const int &value) {
+		wide_order = wide_order && value == rank && key == 1000 - rank * 37;
+		++rank;
+	});
+	std::cout << calls << " " << wide_order << " " << rank << std::endl;
+	//	test: every shard hashes with the given hash, not with Hash()
+	size_t hashed = 0;
+	sjtu::concurrent_linked_hashmap<int, int, counting_hash> stateful(2, counting_hash(&hashed));
+	for (int i = 0; i < 200; ++i) {
+		stateful.insert(sjtu::pair<const int, int>(i, i));
+	}
+	std::cout << stateful.size() << " " << stateful.contains(150) << " " << (hashed > 200) << std::endl;
+}
+
+int main(void) {
+	tester();
+}
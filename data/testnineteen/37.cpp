@@ -0,0 +1,78 @@
+//	the checked iterators of SJTU_LINKED_HASHMAP_ITERATOR_CHECKS 2
+#define SJTU_LINKED_HASHMAP_ITERATOR_CHECKS 2
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <string>
+
+typedef sjtu::linked_hashmap<int, std::string> map_type;
+
+template<class F>
+bool throws(F f) {
+	try {
+		f();
+	} catch (sjtu::invalid_iterator &) {
+		return true;
+	}
+	return false;
+}
+
+void tester(void) {
+	map_type map;
+	for (int i = 0; i < 20; ++i) {
+		map[i] = "value" + std::to_string(i);
+	}
+	//	test: an iterator to an erased element is stale, even once its node is reused
+	map_type::iterator gone = map.find(5);
+	const void *where = &*gone;
+	map.erase(gone);
+	std::cout << throws([&] { *gone; }) << throws([&] { ++gone; }) << throws([&] { --gone; })
+		<< throws([&] { map.erase(gone); }) << " ";
+	map[100] = "reused";
+	map_type::iterator reused = map.find(100);
+	std::cout << (static_cast<const void *>(&*reused) == where) << throws([&] { *gone; })
+		<< " " << reused->second << std::endl;
+	//	test: growing the table, reordering and erasing others leave iterators alone
+	map_type::iterator kept = map.find(7);
+	map_type::iterator end = map.end();
+	for (int i = 200; i < 2000; ++i) {
+		map[i] = "value" + std::to_string(i);
+	}
+	map.move_to_back(kept);
+	map.erase(map.find(8));
+	--end;
+	std::cout << kept->second << " " << (end == kept) << " " << map.size() << std::endl;
+	//	test: extract takes an element out of its iterators' reach
+	map_type::iterator taken = map.find(9);
+	map_type::node_type handle = map.extract(taken);
+	std::cout << throws([&] { *taken; }) << " " << handle.key() << " ";
+	map_type::insert_return_type back = map.insert(std::move(handle));
+	std::cout << back.inserted << throws([&] { *taken; }) << " " << back.position->second << std::endl;
+	//	test: clear() makes every iterator but end() stale
+	map_type::iterator first = map.begin();
+	map.clear();
+	std::cout << throws([&] { *first; }) << throws([&] { ++first; }) << (map.begin() == map.end()) << " ";
+	for (int i = 0; i < 30; ++i) {
+		map[i] = "again";
+	}
+	std::cout << throws([&] { *first; }) << " " << map.size() << " " << map.begin()->first << std::endl;
+	//	test: the usual checks still hold
+	map_type other;
+	other[1] = "other";
+	std::cout << throws([&] { map.erase(other.begin()); }) << throws([&] { map.erase(map.end()); })
+		<< throws([&] { ++map.end(); }) << throws([&] { --map.begin(); }) << throws([&] { map_type::iterator it; ++it; })
+		<< std::endl;
+	//	test: erase_if and pop_front make the iterators of what they remove stale
+	map_type::iterator odd = map.find(3), oldest = map.begin(), even = map.find(4);
+	map.erase_if([](const map_type::value_type &value) { return value.first % 2 == 1; });
+	std::cout << throws([&] { *odd; }) << throws([&] { *even; }) << " ";
+	map.pop_front();
+	std::cout << throws([&] { *oldest; }) << " " << map.begin()->first << " ";
+	map = other;
+	std::cout << map.begin()->second << std::endl;
+	std::cout << (sizeof(map_type::iterator) == 2 * sizeof(void *) + sizeof(size_t)) << std::endl;
+}
+
+int main() {
+	tester();
+	return 0;
+}
@@ -0,0 +1,197 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <cassert>
+#include <string>
+#include <vector>
+#include <list>
+#include <type_traits>
+class Heavy {
+public:
+	static int constructed, copied, moved;
+	std::string payload;
+
+	Heavy() : payload() {
+		constructed++;
+	}
+
+	explicit Heavy(const std::string &payload) : payload(payload) {
+		constructed++;
+	}
+
+	Heavy(int times, char c) : payload(times, c) {
+		constructed++;
+	}
+
+	Heavy(const Heavy &rhs) : payload(rhs.payload) {
+		copied++;
+	}
+
+	Heavy(Heavy &&rhs) : payload(std::move(rhs.payload)) {
+		moved++;
+	}
+
+	Heavy & operator = (const Heavy &rhs) {
+		payload = rhs.payload;
+		copied++;
+		return *this;
+	}
+
+	Heavy & operator = (Heavy &&rhs) {
+		payload = std::move(rhs.payload);
+		moved++;
+		return *this;
+	}
+};
+
+int Heavy::constructed = 0;
+int Heavy::copied = 0;
+int Heavy::moved = 0;
+
+//	a hash whose copy may throw, so maps using it cannot move without throwing
+struct throwing_hash {
+	throwing_hash() {}
+	throwing_hash(const throwing_hash &) {}
+
+	size_t operator()(int key) const {
+		return static_cast<size_t>(key);
+	}
+};
+
+//	test: moves are noexcept unless Hash, Equal or the allocator say otherwise
+static_assert(std::is_nothrow_move_constructible<sjtu::linked_hashmap<int, Heavy> >::value, "move constructor");
+static_assert(std::is_nothrow_move_assignable<sjtu::linked_hashmap<int, Heavy> >::value, "move assignment");
+static_assert(std::is_nothrow_move_constructible<sjtu::linked_hashmap<std::string, int, sjtu::seeded_hash> >::value,
+	"seeded move constructor");
+static_assert(!std::is_nothrow_move_constructible<sjtu::linked_hashmap<int, int, throwing_hash> >::value,
+	"throwing hash");
+
+void report(const char *what) {
+	std::cout << what << ": " << Heavy::constructed << " " << Heavy::copied << " " << Heavy::moved << std::endl;
+	Heavy::constructed = Heavy::copied = Heavy::moved = 0;
+}
+
+void tester(void) {
+	sjtu::linked_hashmap<int, Heavy> map;
+	//	test: operator[] builds the value in place
+	for (int i = 0; i < 1000; ++i) {
+		map[i].payload = "x";
+	}
+	report("operator[]");
+	//	test: try_emplace builds once and leaves existing keys alone
+	for (int i = 0; i < 2000; ++i) {
+		map.try_emplace(i, 3, 'y');
+	}
+	report("try_emplace");
+	//	test: emplace from pieces
+	for (int i = 2000; i < 3000; ++i) {
+		map.emplace(i, Heavy("z"));
+	}
+	report("emplace");
+	//	test: insert of an rvalue value_type moves the mapped value
+	for (int i = 3000; i < 4000; ++i) {
+		map.insert(sjtu::linked_hashmap<int, Heavy>::value_type(i, Heavy("w")));
+	}
+	report("insert&&");
+	//	test: insert_or_assign
+	for (int i = 3500; i < 4500; ++i) {
+		auto result = map.insert_or_assign(i, Heavy("v"));
+		assert(result.second == (i >= 4000));
+	}
+	report("insert_or_assign");
+	//	test: reserve() and rehash() keep every element reachable
+	map.reserve(100000);
+	size_t reserved = map.bucket_count();
+	for (int i = 4500; i < 100000; ++i) {
+		map.try_emplace(i);
+	}
+	assert(map.bucket_count() == reserved);
+	assert(map.load_factor() <= map.max_load_factor());
+	map.max_load_factor(0.25f);
+	map.rehash(0);
+	assert(map.load_factor() <= 0.25f);
+	int found = 0;
+	for (int i = 0; i < 100000; ++i) {
+		found += map.count(i);
+	}
+	std::cout << found << " " << map.size() << std::endl;
+	//	test: insertion order survives all of the above
+	int expected = 0;
+	bool ordered = true;
+	for (auto it = map.cbegin(); it != map.cend(); ++it) {
+		ordered = ordered && it->first == expected++;
+	}
+	std::cout << ordered << " " << map.at(500).payload << map.at(1500).payload << map.at(2500).payload
+		<< map.at(3200).payload << map.at(3700).payload << map.at(4200).payload << std::endl;
+	//	test: a copy has the same buckets and order and copies each value once
+	map.erase(7);
+	map.erase(99999);
+	report("reset");
+	sjtu::linked_hashmap<int, Heavy> copy(map);
+	report("copy");
+	bool same = copy.size() == map.size() && copy.bucket_count() == map.bucket_count();
+	auto lhs = map.cbegin();
+	for (auto rhs = copy.cbegin(); rhs != copy.cend(); ++lhs, ++rhs) {
+		same = same && lhs->first == rhs->first && lhs->second.payload == rhs->second.payload;
+	}
+	copy.erase(0);
+	copy[100000].payload = "u";
+	std::cout << same << " " << copy.count(0) << map.count(0) << " " << copy.count(100000) << map.count(100000) << std::endl;
+	//	test: moves hand the elements over without touching them
+	sjtu::linked_hashmap<int, Heavy> moved(std::move(copy));
+	std::cout << moved.size() << " " << copy.size() << " " << (copy.begin() == copy.end()) << std::endl;
+	copy[1].payload = "t";
+	copy = std::move(moved);
+	moved = copy;
+	report("move and assign");
+	std::cout << copy.size() << " " << moved.size() << " " << copy.count(1) << " " << copy.at(100000).payload
+		<< moved.at(100000).payload << " " << (--copy.end())->first << std::endl;
+	//	so a growing vector of maps moves them instead of copying every value
+	std::vector<sjtu::linked_hashmap<int, Heavy> > maps;
+	for (int i = 0; i < 100; ++i) {
+		maps.push_back(sjtu::linked_hashmap<int, Heavy>());
+		maps.back()[i].payload = "w";
+	}
+	report("vector growth");
+	std::cout << maps[0].at(0).payload << maps[99].at(99).payload << " " << maps[50].size() << std::endl;
+	//	test: bulk insert keeps range order and skips present keys
+	sjtu::linked_hashmap<int, int> bulk;
+	bulk.insert(sjtu::pair<const int, int>(5, -5));
+	std::vector<sjtu::pair<const int, int> > records;
+	for (int i = 0; i < 1000; ++i) {
+		records.push_back(sjtu::pair<const int, int>(i % 700, i));
+	}
+	bulk.insert(records.begin(), records.end());
+	std::list<sjtu::pair<const int, int> > more(records.begin(), records.begin() + 10);
+	bulk.insert(more.begin(), more.end());
+	long long sum = 0;
+	for (auto it = bulk.cbegin(); it != bulk.cend(); ++it) {
+		sum += it->second;
+	}
+	std::cout << bulk.size() << " " << bulk.cbegin()->first << " " << (++bulk.cbegin())->first << " "
+		<< (--bulk.cend())->first << " " << sum << std::endl;
+	//	test: find_batch answers each key in order
+	std::vector<int> wanted;
+	for (int i = -3; i < 1000; i += 7) {
+		wanted.push_back(i);
+	}
+	std::vector<sjtu::linked_hashmap<int, int>::iterator> hits;
+	bulk.find_batch(wanted.begin(), wanted.end(), std::back_inserter(hits));
+	const sjtu::linked_hashmap<int, int> &view = bulk;
+	std::vector<sjtu::linked_hashmap<int, int>::const_iterator> const_hits(wanted.size());
+	view.find_batch(wanted.begin(), wanted.end(), const_hits.begin());
+	bool answered = hits.size() == wanted.size();
+	for (size_t i = 0; i < wanted.size(); ++i) {
+		answered = answered && hits[i] == bulk.find(wanted[i]) && const_hits[i] == view.find(wanted[i]);
+	}
+	//	test: erase_if in one pass
+	size_t erased = bulk.erase_if([](const sjtu::pair<const int, int> &entry) { return entry.first % 2 == 0; });
+	bool odd = true;
+	for (auto it = bulk.cbegin(); it != bulk.cend(); ++it) {
+		odd = odd && it->first % 2 == 1;
+	}
+	std::cout << answered << " " << erased << " " << bulk.size() << " " << odd << " " << bulk.cbegin()->first << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,200 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+
+//	every trip to the heap is counted
+static size_t heap_allocations = 0;
+
+void * operator new(size_t size) {
+	++heap_allocations;
+	if (void *p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+	std::free(p);
+}
+
+void * operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete[](void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+	std::free(p);
+}
+
+//	counts what the value type's copy constructor is asked for
+struct tracked {
+	static int copies;
+	int value;
+
+	tracked(int value) : value(value) {}
+	tracked(const tracked &other) : value(other.value) {
+		++copies;
+	}
+	tracked(tracked &&other) : value(other.value) {}
+	tracked & operator=(const tracked &other) {
+		value = other.value;
+		++copies;
+		return *this;
+	}
+};
+
+int tracked::copies = 0;
+
+//	a hash with a seed of its own, so cached hashes do not carry over
+class seeded {
+public:
+	size_t seed;
+
+	seeded(size_t seed = 0) : seed(seed) {}
+	size_t operator () (const std::string &key) const {
+		return std::hash<std::string>()(key) ^ seed;
+	}
+};
+
+typedef sjtu::pair<const std::string, tracked> value_type;
+typedef sjtu::linked_hashmap<std::string, tracked, std::hash<std::string>, std::equal_to<std::string>,
+	std::allocator<value_type> > plain_map;
+typedef sjtu::linked_hashmap<std::string, tracked, std::hash<std::string>, std::equal_to<std::string>,
+	sjtu::shared_pool_allocator<value_type> > shared_map;
+typedef sjtu::linked_hashmap<std::string, tracked> pool_map;
+typedef sjtu::linked_hashmap<std::string, tracked, seeded, std::equal_to<std::string>,
+	std::allocator<value_type> > seeded_map;
+
+template<class Map>
+void print(const Map &map) {
+	for (typename Map::const_iterator it = map.cbegin(); it != map.cend(); ++it) {
+		std::cout << it->first << ":" << it->second.value << " ";
+	}
+	std::cout << map.size() << std::endl;
+}
+
+template<class Map>
+void fill(Map &map, int from, int to) {
+	for (int i = from; i < to; ++i) {
+		map.insert(value_type("key" + std::to_string(i), tracked(i)));
+	}
+}
+
+//	moves elements between two maps and reports heap traffic and copies
+template<class Map>
+void exercise(Map &hot, Map &cold) {
+	fill(hot, 0, 12);
+	fill(cold, 10, 14);
+	tracked::copies = 0;
+	const value_type *address = &*hot.find("key3");
+	size_t before = heap_allocations;
+	typename Map::node_type handle = hot.extract("key3");
+	std::cout << handle.empty() << " " << handle.key() << " " << handle.mapped().value << " " << hot.count("key3") << " ";
+	handle.mapped().value = 33;
+	typename Map::insert_return_type result = cold.insert(std::move(handle));
+	std::cout << result.inserted << " " << result.node.empty() << " " << handle.empty() << " " << result.position->second.value
+		<< " " << (&*result.position == address) << " " << (heap_allocations - before) << std::endl;
+	//	test: a key already present hands the node back
+	typename Map::node_type again = hot.extract(hot.find("key11"));
+	result = cold.insert(std::move(again));
+	std::cout << result.inserted << " " << result.node.key() << " " << result.position->second.value << " "
+		<< hot.count("key11") << " " << cold.find("key11")->second.value << std::endl;
+	//	test: merge moves what is missing, in order, and leaves the rest
+	cold.reserve(32);
+	before = heap_allocations;
+	cold.merge(hot);
+	std::cout << (heap_allocations - before) << " " << tracked::copies << std::endl;
+	print(hot);
+	print(cold);
+	for (int i = 0; i < 14; ++i) {
+		if (!cold.count("key" + std::to_string(i)) && i != 11) {
+			std::cout << "missing " << i << std::endl;
+		}
+	}
+	//	test: an empty handle inserts nothing; an empty extract is empty
+	typename Map::node_type none = cold.extract("absent");
+	result = cold.insert(std::move(none));
+	std::cout << none.empty() << " " << result.inserted << " " << (result.position == cold.end()) << " " << cold.size() << std::endl;
+	//	test: handles move and swap; a dropped handle frees its node
+	typename Map::node_type first = cold.extract(cold.begin());
+	typename Map::node_type second = cold.extract(cold.begin());
+	first.swap(second);
+	typename Map::node_type moved(std::move(first));
+	std::cout << moved.key() << " " << second.key() << " " << first.empty() << " " << cold.size() << std::endl;
+	second = std::move(moved);
+	std::cout << second.key() << " " << moved.empty() << std::endl;
+	try {
+		moved.key();
+	} catch (sjtu::container_is_empty &) {
+		std::cout << "empty handle" << std::endl;
+	}
+	//	test: every element is still found through the index
+	cold.merge(hot);
+	cold.insert(std::move(second));
+	size_t found = 0;
+	for (int i = 0; i < 14; ++i) {
+		found += cold.count("key" + std::to_string(i));
+	}
+	std::cout << found << " " << cold.size() << " " << hot.size() << " " << tracked::copies << std::endl;
+}
+
+void tester(void) {
+	plain_map plain_hot, plain_cold;
+	exercise(plain_hot, plain_cold);
+	//	maps sharing one pool relink as std::allocator maps do
+	sjtu::shared_pool_allocator<value_type> pool;
+	shared_map shared_hot(0, std::hash<std::string>(), std::equal_to<std::string>(), pool);
+	shared_map shared_cold(0, std::hash<std::string>(), std::equal_to<std::string>(), pool);
+	exercise(shared_hot, shared_cold);
+	//	the default allocator relinks just the same between maps built from one pool
+	sjtu::pool_allocator<value_type> common;
+	pool_map common_hot(0, std::hash<std::string>(), std::equal_to<std::string>(), common);
+	pool_map common_cold(0, std::hash<std::string>(), std::equal_to<std::string>(), common);
+	exercise(common_hot, common_cold);
+	//	unrelated pool_allocator maps share no memory: elements are moved, not copied
+	pool_map pool_hot, pool_cold;
+	exercise(pool_hot, pool_cold);
+	//	test: a round trip through a handle of the default map type allocates nothing
+	size_t before = heap_allocations;
+	const value_type *address = &*pool_cold.begin();
+	pool_map::node_type handle = pool_cold.extract(pool_cold.begin());
+	pool_map::insert_return_type back = pool_cold.insert(std::move(handle));
+	bool relinked = back.inserted && &*back.position == address && &*--pool_cold.end() == address;
+	pool_map::node_type dropped = pool_cold.extract(pool_cold.begin());
+	dropped = pool_map::node_type();
+	pool_cold.clear();
+	std::cout << relinked << " " << (heap_allocations - before) << " " << pool_cold.size() << " " << dropped.empty() << std::endl;
+	//	test: maps of different seeds rehash what they take over
+	seeded_map left(0, seeded(1)), right(0, seeded(12345));
+	fill(left, 0, 40);
+	fill(right, 30, 50);
+	right.merge(left);
+	size_t found = 0;
+	for (int i = 0; i < 50; ++i) {
+		found += right.count("key" + std::to_string(i));
+	}
+	std::cout << found << " " << left.size() << " " << right.size() << " " << right.begin()->first << " "
+		<< (--right.end())->first << std::endl;
+	//	test: a move-only mapped type goes through handles and merge
+	sjtu::linked_hashmap<int, std::unique_ptr<int> > owners, others;
+	for (int i = 0; i < 10; ++i) {
+		owners.insert(sjtu::pair<const int, std::unique_ptr<int> >(i, std::unique_ptr<int>(new int(i * i))));
+	}
+	others.insert(owners.extract(7));
+	others.merge(owners);
+	std::cout << *others.at(7) << " " << *others.at(9) << " " << others.begin()->first << " " << owners.size() << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,158 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <cstdlib>
+#include <new>
+
+//	every trip to the heap is counted
+static size_t heap_allocations = 0;
+
+void * operator new(size_t size) {
+	++heap_allocations;
+	if (void *p = std::malloc(size ? size : 1)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void *p, size_t) noexcept {
+	std::free(p);
+}
+
+void * operator new[](size_t size) {
+	return operator new(size);
+}
+
+void operator delete[](void *p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept {
+	std::free(p);
+}
+
+typedef sjtu::linked_hashmap<int, int> map_type;
+
+void print(const map_type &map) {
+	for (map_type::const_iterator it = map.cbegin(); it != map.cend(); ++it) {
+		std::cout << it->first << ":" << it->second << " ";
+	}
+	std::cout << map.size() << " " << map.bucket_count() << std::endl;
+}
+
+//	builds a map whose nodes are no longer one run, copies it and checks the copy
+template<class Map>
+bool copies_exactly(Map &map) {
+	for (int i = 0; i < 1000; ++i) {
+		map[i * 7] = i;
+	}
+	for (int i = 0; i < 1000; i += 3) {
+		map.erase(i * 7);
+	}
+	for (int i = 0; i < 200; ++i) {
+		map[-i] = i;
+	}
+	const Map copy(map);
+	bool same = copy.size() == map.size();
+	typename Map::const_iterator it = map.cbegin();
+	for (typename Map::const_iterator at = copy.cbegin(); same && at != copy.cend(); ++at, ++it) {
+		same = at->first == it->first && at->second == it->second;
+	}
+	for (int i = -200; same && i < 7000; ++i) {
+		same = copy.count(i) == map.count(i);
+	}
+	return same;
+}
+
+void tester(void) {
+	//	test: an empty map allocates nothing
+	size_t before = heap_allocations;
+	{
+		map_type empty;
+		std::cout << empty.bucket_count() << " " << empty.load_factor() << " " << empty.count(3) << " "
+			<< (empty.find(3) == empty.end()) << " " << (heap_allocations - before) << std::endl;
+		map_type moved(std::move(empty));
+		map_type copy(moved);
+		std::cout << copy.bucket_count() << " " << (heap_allocations - before) << std::endl;
+	}
+	//	test: up to 8 elements take one allocation and no index
+	before = heap_allocations;
+	map_type small;
+	for (int i = 0; i < 8; ++i) {
+		small[i * 7] = i;
+	}
+	std::cout << (heap_allocations - before) << " ";
+	print(small);
+	small.erase(small.find(21));
+	small[21] = 30;
+	small.reserve(8);
+	std::cout << small.at(0) << " " << small.count(21) << " " << small.count(22) << " " << small[21] << " ";
+	print(small);
+	//	test: copies and swaps of a small map stay small
+	map_type copy(small);
+	map_type other;
+	other[100] = 100;
+	other.swap(copy);
+	print(copy);
+	print(other);
+	//	test: the ninth element builds the index, and order is kept
+	small[100] = 8;
+	std::cout << (small.bucket_count() >= 16) << " " << small.count(100) << " " << small.count(14) << " "
+		<< small.count(13) << std::endl;
+	for (int i = 0; i < 1000; ++i) {
+		small[i] += 1;
+	}
+	map_type::iterator it = small.begin();
+	std::cout << it->first << " " << (++it)->first << " " << small.size() << " " << (small.load_factor() <= small.max_load_factor())
+		<< std::endl;
+	//	test: clearing keeps the index; erasing down does not drop it
+	while (small.size() > 2) {
+		small.erase(small.begin());
+	}
+	std::cout << (small.bucket_count() >= 16) << " " << small.count(998) << " " << small.count(999) << std::endl;
+	small.clear();
+	small[5] = 5;
+	std::cout << (small.bucket_count() >= 16) << " " << small.at(5) << std::endl;
+	//	test: asking for buckets builds the index at once
+	map_type asked;
+	asked[1] = 1;
+	asked.reserve(4);
+	std::cout << asked.bucket_count() << " ";
+	asked.reserve(100);
+	std::cout << (asked.bucket_count() >= 100) << " " << asked.at(1) << " ";
+	map_type sized(32);
+	std::cout << (sized.bucket_count() >= 32) << " ";
+	map_type rehashed;
+	rehashed[2] = 2;
+	rehashed.rehash(0);
+	std::cout << (rehashed.bucket_count() > 0) << " " << rehashed.at(2) << std::endl;
+	//	test: a small map is searched by key, not by hash alone
+	sjtu::linked_hashmap<int, int> keys;
+	int lookup[] = {4, 8, 15, 16};
+	for (int i = 0; i < 4; ++i) {
+		keys[lookup[i]] = i;
+	}
+	map_type::iterator found[4];
+	keys.find_batch(lookup, lookup + 4, found);
+	std::cout << found[0]->second << found[1]->second << found[2]->second << found[3]->second << " "
+		<< keys.bucket_count() << std::endl;
+	//	test: copies of trivially copyable elements, hashes cached or not
+	map_type plain;
+	sjtu::linked_hashmap<int, int, sjtu::integral_hash> mixed;
+	sjtu::linked_hashmap<int, int, sjtu::seeded_hash> cached(0, sjtu::seeded_hash(1, 2));
+	std::cout << copies_exactly(plain) << copies_exactly(mixed) << copies_exactly(cached) << " " << mixed.size() << std::endl;
+	//	test: integral_hash gives distinct keys distinct hashes
+	sjtu::integral_hash hash;
+	sjtu::linked_hashmap<size_t, int> hashes;
+	for (long long key = -500; key < 500; ++key) {
+		hashes[hash(key)] = 0;
+	}
+	std::cout << hashes.size() << " " << (hash(1) != 1) << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,79 @@
+#include "rcu_linked_hashmap.hpp"
+#include <iostream>
+#include <cassert>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int READERS = 3;
+const int UPDATES = 300;
+
+typedef sjtu::rcu_linked_hashmap<int, long long> map_type;
+
+void tester(void) {
+	map_type map;
+	//	test: every update keeps keys 0..n-1 in order with value sum 0,
+	//	so a reader sees either all of an update or nothing of it
+	std::atomic<bool> done(false);
+	std::atomic<long long> snapshots(0);
+	std::vector<std::thread> readers;
+	for (int t = 0; t < READERS; ++t) {
+		readers.push_back(std::thread([&]() {
+			do {
+				map_type::snapshot s = map.read();
+				long long sum = 0;
+				int expected = 0;
+				for (auto it = s->cbegin(); it != s->cend(); ++it) {
+					assert(it->first == expected++);
+					sum += it->second;
+				}
+				assert(sum == 0 && static_cast<size_t>(expected) == s->size());
+				long long value;
+				assert(!map.find(1, value) || value == 1);
+				snapshots.fetch_add(1);
+			} while (!done.load());
+		}));
+	}
+	for (int i = 0; i < UPDATES; ++i) {
+		map.update([](map_type::map_type &m) {
+			int n = static_cast<int>(m.size());
+			m[n] = n;
+			m[0] -= n;
+		});
+	}
+	done.store(true);
+	for (size_t i = 0; i < readers.size(); ++i) {
+		readers[i].join();
+	}
+	std::cout << map.size() << " " << (snapshots.load() >= READERS) << std::endl;
+	//	test: single updates
+	std::cout << map.insert(sjtu::pair<const int, long long>(5, 1)) << " "
+		<< map.insert(sjtu::pair<const int, long long>(1000, 1)) << " "
+		<< map.insert_or_assign(1000, 2ll) << " " << map.insert_or_assign(1001, 3ll) << std::endl;
+	long long value = 0;
+	std::cout << map.find(1000, value) << value << " " << map.erase(1001) << map.erase(1001) << " " << map.count(1001) << std::endl;
+	//	test: a snapshot outlives later updates unchanged
+	{
+		map_type::snapshot before = map.read();
+		map.clear();
+		std::cout << before->size() << " " << map.size() << " " << map.empty() << std::endl;
+	}
+	//	test: update returns what the callback returns, a throwing callback publishes nothing
+	std::cout << map.update([](map_type::map_type &m) { return m.insert(sjtu::pair<const int, long long>(7, 7)).second; }) << " ";
+	try {
+		map.update([](map_type::map_type &m) {
+			m.clear();
+			throw sjtu::runtime_error();
+		});
+	} catch (sjtu::runtime_error &) {
+		std::cout << "kept ";
+	}
+	int visited = 0;
+	map.for_each([&visited](const map_type::value_type &entry) { visited += entry.first; });
+	std::cout << visited << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,70 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <string>
+
+//	every key collides: the kind of Hash that makes a map degrade
+class Constant {
+public:
+	size_t operator () (int) const {
+		return 42;
+	}
+};
+
+size_t lookups(const size_t (&histogram)[sjtu::linked_hashmap_stats::BINS]) {
+	size_t total = 0;
+	for (size_t i = 0; i < sjtu::linked_hashmap_stats::BINS; ++i) {
+		total += histogram[i];
+	}
+	return total;
+}
+
+typedef sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>,
+	sjtu::pool_allocator<sjtu::pair<const int, int> >, SJTU_LINKED_HASHMAP_DEFAULT_ENGINE, sjtu::linked_hashmap_stats> good_map;
+typedef sjtu::linked_hashmap<int, int, Constant, std::equal_to<int>,
+	std::allocator<sjtu::pair<const int, int> >, SJTU_LINKED_HASHMAP_DEFAULT_ENGINE, sjtu::linked_hashmap_stats> bad_map;
+
+void tester(void) {
+	//	test: the default policy records nothing
+	sjtu::linked_hashmap<int, int> plain;
+	plain[1] = 1;
+	sjtu::no_stats none = plain.stats();
+	(void)none;
+	std::cout << sjtu::no_stats::enabled << " " << sjtu::linked_hashmap_stats::bin(0) << sjtu::linked_hashmap_stats::bin(1)
+		<< sjtu::linked_hashmap_stats::bin(3) << sjtu::linked_hashmap_stats::bin(4) << std::endl;
+	//	test: a good hash keeps lookups short (a map of up to 8 elements
+	//	walks its list, so up to 8 probes)
+	good_map good;
+	for (int i = 0; i < 1000; ++i) {
+		good[i] = i;
+	}
+	for (int i = 0; i < 2000; ++i) {
+		good.count(i);
+	}
+	sjtu::linked_hashmap_stats s = good.stats();
+	std::cout << lookups(s.find_probes) << " " << lookups(s.insert_probes) << " "
+		<< (s.max_probes <= 8) << " " << (s.rehashes > 0) << " " << (s.peak_bucket_count >= 1000) << " "
+		<< (s.peak_bucket_count == good.bucket_count()) << " " << s.allocations << " " << s.deallocations << std::endl;
+	good.erase(5);
+	good.clear();
+	s = good.stats();
+	std::cout << s.allocations << " " << s.deallocations << std::endl;
+	//	test: a constant hash shows up as long lookups
+	bad_map bad;
+	for (int i = 0; i < 100; ++i) {
+		bad.insert(sjtu::pair<const int, int>(i, i));
+	}
+	bad.find(1000);
+	s = bad.stats();
+	std::cout << lookups(s.find_probes) << " " << s.find_probes[7] << " " << s.max_probes << " "
+		<< lookups(s.insert_probes) << " " << s.insert_probes[0] << " " << s.insert_probes[7] << std::endl;
+	bad_map copy(bad);
+	bad_map moved(std::move(bad));
+	std::cout << copy.stats().max_probes << " " << copy.stats().allocations << " " << moved.stats().max_probes << std::endl;
+	moved.reset_stats();
+	s = moved.stats();
+	std::cout << s.max_probes << " " << s.allocations << " " << s.rehashes << " " << (s.peak_bucket_count == moved.bucket_count()) << std::endl;
+}
+
+int main(void) {
+	tester();
+}
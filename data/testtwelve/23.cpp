@@ -0,0 +1,173 @@
+#include "dense_linked_hashmap.hpp"
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <cassert>
+#include <cstdlib>
+#include <string>
+#include <type_traits>
+
+//	test: moves and swap are noexcept for the default Hash, Equal and allocator
+static_assert(std::is_nothrow_move_constructible<sjtu::dense_linked_hashmap<std::string, int> >::value, "move constructor");
+static_assert(std::is_nothrow_move_assignable<sjtu::dense_linked_hashmap<std::string, int> >::value, "move assignment");
+static_assert(noexcept(std::declval<sjtu::dense_linked_hashmap<int, int> &>().swap(std::declval<sjtu::dense_linked_hashmap<int, int> &>())),
+	"swap");
+
+//	the same operations on both maps must give the same contents, in the same order
+template<class Dense, class Reference>
+bool same(const Dense &dense, const Reference &reference) {
+	if (dense.size() != reference.size()) {
+		return false;
+	}
+	auto it = dense.cbegin();
+	for (auto ref = reference.cbegin(); ref != reference.cend(); ++ref, ++it) {
+		if (!(it->first == ref->first) || !(it->second == ref->second)) {
+			return false;
+		}
+	}
+	return it == dense.cend();
+}
+
+template<class Key, class MakeKey>
+void random_test(const char *name, MakeKey make_key, int range) {
+	sjtu::dense_linked_hashmap<Key, int> dense;
+	sjtu::linked_hashmap<Key, int> reference;
+	srand(2024);
+	bool ok = true;
+	for (int i = 0; i < 200000; ++i) {
+		Key key = make_key(rand() % range);
+		switch (rand() % 6) {
+		case 0:
+		case 1:
+			ok = ok && dense.insert(sjtu::pair<const Key, int>(key, i)).second
+				== reference.insert(sjtu::pair<const Key, int>(key, i)).second;
+			break;
+		case 2:
+			dense[key] += i;
+			reference[key] += i;
+			break;
+		case 3:
+			ok = ok && dense.erase(key) == reference.erase(key);
+			break;
+		case 4: {
+			auto it = dense.find(key);
+			ok = ok && (it == dense.end()) == (reference.find(key) == reference.end());
+			if (it != dense.end()) {
+				dense.erase(it);
+				reference.erase(reference.find(key));
+			}
+			break;
+		}
+		default:
+			ok = ok && dense.count(key) == reference.count(key);
+		}
+	}
+	ok = ok && same(dense, reference);
+	sjtu::dense_linked_hashmap<Key, int> copy(dense);
+	dense.rehash(dense.bucket_count() * 4);
+	ok = ok && same(copy, reference) && same(dense, reference) && copy.bucket_count() * 4 == dense.bucket_count();
+	std::cout << name << ": " << ok << " " << dense.size() << std::endl;
+}
+
+int identity(int i) {
+	return i;
+}
+
+std::string text(int i) {
+	return "key-" + std::to_string(i * 7);
+}
+
+void tester(void) {
+	random_test<int>("int", identity, 5000);
+	random_test<std::string>("string", text, 5000);
+	//	test: iterators, order and exceptions
+	sjtu::dense_linked_hashmap<int, std::string> map;
+	for (int i = 0; i < 10; ++i) {
+		map[i] = std::to_string(i);
+	}
+	map.erase(0);
+	map.erase(5);
+	map.insert(sjtu::pair<const int, std::string>(0, "zero"));
+	map.insert_or_assign(9, std::string("nine"));
+	map.try_emplace(20, 3, 'x');
+	for (auto it = map.begin(); it != map.end(); it++) {
+		std::cout << it->first << "=" << (*it).second << " ";
+	}
+	std::cout << std::endl;
+	int caught = 0;
+	try {
+		++map.end();
+	} catch (sjtu::invalid_iterator &) {
+		++caught;
+	}
+	try {
+		--map.begin();
+	} catch (sjtu::invalid_iterator &) {
+		++caught;
+	}
+	try {
+		map.at(5);
+	} catch (sjtu::index_out_of_bound &) {
+		++caught;
+	}
+	try {
+		sjtu::dense_linked_hashmap<int, std::string> other;
+		map.erase(other.end());
+	} catch (sjtu::invalid_iterator &) {
+		++caught;
+	}
+	const sjtu::dense_linked_hashmap<int, std::string> &view = map;
+	try {
+		view[100];
+	} catch (sjtu::index_out_of_bound &) {
+		++caught;
+	}
+	std::cout << caught << " " << (--map.end())->first << " " << view.at(20) << std::endl;
+	//	test: a sliding window of keys reuses the array instead of growing it
+	sjtu::dense_linked_hashmap<int, int> window;
+	for (int i = 0; i < 100000; ++i) {
+		window[i] = i;
+		if (i >= 8) {
+			window.erase(i - 8);
+		}
+	}
+	int sum = 0;
+	for (auto it = window.cbegin(); it != window.cend(); ++it) {
+		sum += it->first - 99992;
+	}
+	std::cout << window.size() << " " << sum << " " << (window.bucket_count() <= 64) << " " << (--window.end())->second << std::endl;
+	for (int i = 100; i < 100000; ++i) {
+		map[i] = "v";
+	}
+	map[1] += "!";
+	sjtu::dense_linked_hashmap<int, std::string> moved(std::move(map));
+	std::cout << moved.at(1) << " " << moved.size() << " " << map.size() << " " << (map.begin() == map.end()) << std::endl;
+	map = moved;
+	moved.clear();
+	moved[7] = "seven";
+	map = std::move(moved);
+	std::cout << map.size() << " " << map.cbegin()->second << " " << moved.size() << std::endl;
+	//	test: a moved-from map holds no buckets, and works as an empty map
+	sjtu::dense_linked_hashmap<int, std::string> empty(std::move(map));
+	const sjtu::dense_linked_hashmap<int, std::string> copy(map);
+	std::cout << map.bucket_count() << " " << map.load_factor() << " " << map.count(7) << map.erase(7) << (map.find(7) == map.end())
+		<< (map.get(7) == nullptr) << " " << copy.size() << copy.count(7) << " ";
+	map.clear();
+	map[7] = "again";
+	map.rehash(0);
+	std::cout << (map.bucket_count() > 0) << " " << map.at(7) << " " << empty.at(7) << std::endl;
+	//	test: an element built from one already in the map survives the growth it causes
+	sjtu::dense_linked_hashmap<int, std::string> chain;
+	chain[0] = std::string(40, 'c');
+	for (int i = 1; i < 5000; ++i) {
+		chain.try_emplace(i, chain.at(i - 1));
+	}
+	bool intact = true;
+	for (auto it = chain.cbegin(); it != chain.cend(); ++it) {
+		intact = intact && it->second == std::string(40, 'c');
+	}
+	std::cout << chain.size() << " " << intact << std::endl;
+}
+
+int main(void) {
+	tester();
+}
@@ -0,0 +1,114 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <memory>
+#include <string>
+
+typedef sjtu::linked_hashmap<int, std::string> map_type;
+
+template<class Map>
+unsigned long long checksum(const Map &map) {
+	unsigned long long sum = 0, position = 0;
+	for (typename Map::const_iterator it = map.cbegin(); it != map.cend(); ++it) {
+		sum += ++position * static_cast<unsigned long long>(it->first) + it->second.size();
+	}
+	return sum;
+}
+
+template<class F>
+bool throws(F f) {
+	try {
+		f();
+	} catch (sjtu::runtime_error &) {
+		return true;
+	}
+	return false;
+}
+
+void tester(void) {
+	//	test: memory_usage() of an empty map, and of a full one
+	map_type map;
+	sjtu::linked_hashmap_memory empty = map.memory_usage();
+	std::cout << empty.index << " " << empty.nodes << " " << empty.spare << " " << empty.total() << std::endl;
+	for (int i = 0; i < 100000; ++i) {
+		map[i] = "value" + std::to_string(i);
+	}
+	sjtu::linked_hashmap_memory full = map.memory_usage();
+	std::cout << (full.index >= map.bucket_count() * sizeof(void *)) << " " << (full.nodes > 100000 * sizeof(map_type::value_type))
+		<< " " << (full.total() == full.index + full.nodes + full.spare) << std::endl;
+	//	test: erasing keeps buckets and slabs, shrink_to_fit() gives them back
+	for (int i = 0; i < 100000; ++i) {
+		if (i % 100 != 0) {
+			map.erase(i);
+		}
+	}
+	size_t buckets = map.bucket_count();
+	sjtu::linked_hashmap_memory sparse = map.memory_usage();
+	unsigned long long before = checksum(map);
+	map.shrink_to_fit();
+	sjtu::linked_hashmap_memory shrunk = map.memory_usage();
+	std::cout << map.size() << " " << (sparse.spare > 90 * sparse.nodes) << " " << (map.bucket_count() * 16 < buckets) << " "
+		<< (shrunk.spare < shrunk.nodes / 10) << " " << (shrunk.index * 16 < sparse.index) << " " << (checksum(map) == before)
+		<< " " << map.at(4200) << " " << map.count(4201) << std::endl;
+	//	test: a map small enough goes back to having no index at all
+	map.erase_if([](const map_type::value_type &value) { return value.first >= 500; });
+	map.shrink_to_fit();
+	std::cout << map.size() << " " << map.bucket_count() << " " << map.memory_usage().index << " " << map.at(300) << " ";
+	for (int i = 1; i <= 100; ++i) {
+		map[-i] = "again";
+	}
+	std::cout << map.size() << " " << (map.bucket_count() > 0) << " " << map.at(-50) << std::endl;
+	//	test: min_load_factor() shrinks the index on erase, iterators staying valid
+	std::cout << map.min_load_factor() << " " << throws([&] { map.min_load_factor(-1); })
+		<< throws([&] { map.min_load_factor(0.5f); }) << " ";
+	map.clear();
+	map.min_load_factor(0.1f);
+	std::cout << throws([&] { map.max_load_factor(0.3f); }) << " ";
+	for (int i = 0; i < 100000; ++i) {
+		map[i] = "value";
+	}
+	map_type::iterator kept = map.find(99999);
+	buckets = map.bucket_count();
+	for (int i = 0; i < 99900; ++i) {
+		map.erase(i);
+	}
+	std::cout << map.size() << " " << (map.bucket_count() * 100 < buckets) << " " << (map.load_factor() >= 0.1f) << " "
+		<< kept->first << " " << map.at(99950) << std::endl;
+	//	test: clear() then drops the index and the slabs
+	map.clear();
+	sjtu::linked_hashmap_memory cleared = map.memory_usage();
+	std::cout << map.bucket_count() << " " << cleared.index + cleared.nodes << " ";
+	map[1] = "one";
+	std::cout << map.at(1) << std::endl;
+	//	test: no rebuild storm for a size that hovers around the threshold
+	sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, sjtu::pool_allocator<sjtu::pair<const int, int> >,
+		SJTU_LINKED_HASHMAP_DEFAULT_ENGINE, sjtu::linked_hashmap_stats> counted;
+	counted.min_load_factor(0.1f);
+	for (int i = 0; i < 10000; ++i) {
+		counted[i] = i;
+	}
+	for (int i = 0; i < 9000; ++i) {
+		counted.erase(i);
+	}
+	size_t rehashes = counted.stats().rehashes;
+	for (int round = 0; round < 1000; ++round) {
+		counted.erase(9000 + round % 1000);
+		counted[9000 + round % 1000] = round;
+	}
+	std::cout << counted.size() << " " << (counted.stats().rehashes == rehashes) << std::endl;
+	//	test: without a pool shrink_to_fit() shrinks the index
+	sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, std::allocator<sjtu::pair<const int, int> > > plain;
+	for (int i = 0; i < 10000; ++i) {
+		plain[i] = i;
+	}
+	for (int i = 0; i < 9990; ++i) {
+		plain.erase(i);
+	}
+	buckets = plain.bucket_count();
+	plain.shrink_to_fit();
+	std::cout << plain.size() << " " << (plain.bucket_count() * 100 < buckets) << " " << plain.at(9995) << std::endl;
+}
+
+int main() {
+	tester();
+	return 0;
+}
@@ -0,0 +1,94 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <cmath>
+#include <functional>
+
+typedef sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, sjtu::pool_allocator<sjtu::pair<const int, int> >,
+	SJTU_LINKED_HASHMAP_DEFAULT_ENGINE, sjtu::linked_hashmap_stats> map_type;
+
+template<class F>
+bool throws(F f) {
+	try {
+		f();
+	} catch (sjtu::runtime_error &) {
+		return true;
+	}
+	return false;
+}
+
+//	the keys of [first, last) are there with value key, and nothing else
+bool holds(const map_type &map, int first, int last) {
+	for (int i = first; i < last; ++i) {
+		map_type::const_iterator it = map.find(i);
+		if (it == map.cend() || it->second != i) {
+			return false;
+		}
+	}
+	return map.size() == static_cast<size_t>(last - first) && !map.count(first - 1) && !map.count(last);
+}
+
+void tester(void) {
+	//	test: a map built with a bucket count starts with that many, empty
+	map_type sized(1000);
+	std::cout << sized.empty() << " " << (sized.bucket_count() >= 1000) << " " << sized.load_factor() << " "
+		<< sized.max_load_factor() << " " << map_type().load_factor() << std::endl;
+	//	test: reserve(n) then n inserts never rehash
+	for (int n = 10; n <= 100000; n *= 10) {
+		map_type map;
+		map.reserve(n);
+		size_t rehashes = map.stats().rehashes, buckets = map.bucket_count();
+		for (int i = 0; i < n; ++i) {
+			map[i] = i;
+		}
+		std::cout << (map.stats().rehashes - rehashes) << (map.bucket_count() == buckets) << holds(map, 0, n)
+			<< (map.load_factor() <= map.max_load_factor()) << " ";
+	}
+	std::cout << std::endl;
+	//	test: rehash(0) after erasing shrinks the index to what is left,
+	//	elements and iterators staying as they are
+	map_type map;
+	for (int i = 0; i < 50000; ++i) {
+		map[i] = i;
+	}
+	size_t full = map.bucket_count();
+	for (int i = 100; i < 50000; ++i) {
+		map.erase(i);
+	}
+	map_type::iterator kept = map.find(42);
+	map.rehash(0);
+	std::cout << (map.bucket_count() * 100 < full) << " " << holds(map, 0, 100) << " " << kept->second << " " << (++kept)->first
+		<< " " << (map.load_factor() <= map.max_load_factor()) << " ";
+	map.rehash(5000);
+	std::cout << (map.bucket_count() >= 5000) << " " << holds(map, 0, 100) << " " << map.begin()->first << " "
+		<< (--map.end())->first << std::endl;
+	//	test: max_load_factor() takes any positive value and refuses the rest
+	std::cout << throws([&]() { map.max_load_factor(0.0f); }) << throws([&]() { map.max_load_factor(-1.0f); })
+		<< throws([&]() { map.max_load_factor(std::nanf("")); }) << " " << map.max_load_factor() << " ";
+	for (int i = 100; i < 20000; ++i) {
+		map[i] = i;
+	}
+	map.max_load_factor(0.25f);
+	std::cout << map.max_load_factor() << " " << (map.load_factor() <= 0.25f) << " " << holds(map, 0, 20000) << " ";
+	map.max_load_factor(3.0f);
+	map.rehash(0);
+	std::cout << map.max_load_factor() << " " << (map.load_factor() <= 3.0f) << " " << holds(map, 0, 20000) << " ";
+	//	and, with a min_load_factor(), stays four times above it
+	map.min_load_factor(0.5f);
+	std::cout << throws([&]() { map.max_load_factor(1.9f); }) << " " << map.max_load_factor() << " ";
+	map.max_load_factor(2.0f);
+	std::cout << map.max_load_factor() << " " << holds(map, 0, 20000) << std::endl;
+	//	test: clear() keeps the buckets, and the map fills again
+	size_t buckets = map.bucket_count();
+	map.min_load_factor(0.0f);
+	map.clear();
+	std::cout << map.size() << " " << (map.bucket_count() == buckets) << " " << map.load_factor() << " ";
+	for (int i = -500; i < 500; ++i) {
+		map[i] = i;
+	}
+	std::cout << holds(map, -500, 500) << std::endl;
+}
+
+int main() {
+	tester();
+	return 0;
+}
@@ -0,0 +1,119 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+typedef sjtu::linked_hashmap<std::string, int, sjtu::seeded_hash, std::equal_to<> > string_map;
+
+//	sends every hash to the first bucket, as a flooding attack would
+struct one_bucket {
+	static size_t round(size_t n) {
+		return sjtu::power_of_two_mix::round(n);
+	}
+
+	void resize(size_t) {}
+
+	size_t operator()(size_t) const {
+		return 0;
+	}
+};
+
+typedef sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, sjtu::pool_allocator<sjtu::pair<const int, int> >,
+	sjtu::treeified_buckets<one_bucket>, sjtu::linked_hashmap_stats> flooded_map;
+
+//	keys that share their full hash in groups of 50
+struct grouped_hash {
+	size_t operator()(int key) const {
+		return static_cast<size_t>(key % 50);
+	}
+};
+
+template<class Indexing>
+bool against_std_map() {
+	sjtu::linked_hashmap<int, int, grouped_hash, std::equal_to<int>, sjtu::pool_allocator<sjtu::pair<const int, int> >,
+		sjtu::treeified_buckets<Indexing> > map;
+	std::map<int, int> expected;
+	unsigned long long state = 41;
+	for (int step = 0; step < 200000; ++step) {
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		int key = static_cast<int>(state >> 33) % 3000;
+		int op = static_cast<int>(state >> 20) % 3;
+		if (op == 0) {
+			map[key] = step;
+			expected[key] = step;
+		} else if (op == 1) {
+			if (map.erase(key) != expected.erase(key)) {
+				return false;
+			}
+		} else {
+			auto it = map.find(key);
+			auto e = expected.find(key);
+			if ((it == map.end()) != (e == expected.end()) || (it != map.end() && it->second != e->second)) {
+				return false;
+			}
+		}
+		if (step % 50000 == 0) {
+			map.rehash(map.bucket_count() * 2);
+		}
+	}
+	return map.size() == expected.size();
+}
+
+void tester(void) {
+	//	test: every seeded_hash draws its own key, a given key hashes alike
+	sjtu::seeded_hash a, b, fixed(1, 2), again(1, 2);
+	std::cout << (a("linked") != b("linked")) << " " << (fixed("linked") == again("linked")) << " "
+		<< (fixed("linked") != fixed("linkee")) << " " << (fixed(42) == again(42)) << " " << (fixed(42) != fixed(43)) << std::endl;
+	//	test: std::string, string_view and C strings hash alike
+	std::string s = "hash flooding";
+	std::cout << (fixed(s) == fixed(s.c_str())) << " " << (fixed(s) == fixed(std::string_view(s))) << " "
+		<< (fixed(std::string()) == fixed("")) << std::endl;
+	//	test: a seeded map, searched without building std::string
+	string_map words;
+	for (int i = 0; i < 1000; ++i) {
+		words["word" + std::to_string(i)] = i;
+	}
+	std::cout << words.size() << " " << words.count("word999") << " " << words.count(std::string_view("word1000")) << " "
+		<< words.at("word500") << std::endl;
+	//	test: copies keep their seed, merge() rehashes under the target's
+	string_map copy(words), other;
+	for (int i = 500; i < 1500; ++i) {
+		other["word" + std::to_string(i)] = -i;
+	}
+	other.merge(copy);
+	int found = 0;
+	for (int i = 0; i < 1500; ++i) {
+		found += static_cast<int>(other.count("word" + std::to_string(i)));
+	}
+	std::cout << other.size() << " " << copy.size() << " " << found << " " << other.at("word700") << " " << other.at("word7")
+		<< std::endl;
+	//	test: with every key in one bucket, no lookup probes more than a short chain
+	flooded_map flooded;
+	for (int i = 0; i < 20000; ++i) {
+		flooded[i * 7] = i;
+	}
+	long long sum = 0;
+	for (int i = 0; i < 20000; ++i) {
+		sum += flooded.at(i * 7);
+	}
+	std::cout << flooded.size() << " " << sum << " " << flooded.count(5) << " " << flooded.stats().max_probes << std::endl;
+	//	test: the tree shrinks back into a chain, and grows again
+	for (int i = 3; i < 20000; ++i) {
+		flooded.erase(i * 7);
+	}
+	std::cout << flooded.size() << " " << flooded.at(0) << flooded.at(7) << flooded.at(14) << " " << flooded.count(21) << " ";
+	for (int i = 100; i < 120; ++i) {
+		flooded[i] = i;
+	}
+	std::cout << flooded.size() << " " << flooded.at(110) << " " << flooded.at(14) << " " << flooded.count(120) << std::endl;
+	//	test: keys with equal hashes, in trees and in chains, against std::map
+	std::cout << against_std_map<one_bucket>() << " " << against_std_map<sjtu::power_of_two_mix>() << " "
+		<< against_std_map<sjtu::prime_modulo>() << std::endl;
+}
+
+int main() {
+	tester();
+	return 0;
+}
@@ -0,0 +1,147 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <functional>
+#include <vector>
+
+template<class Engine>
+using map_of = sjtu::linked_hashmap<int, int, std::hash<int>, std::equal_to<int>, sjtu::pool_allocator<sjtu::pair<const int, int> >,
+	Engine, sjtu::linked_hashmap_stats>;
+
+//	every key of [0, n) is there with value key, and missing keys are missed
+template<class Map>
+bool holds(const Map &map, int n) {
+	for (int i = 0; i < n; ++i) {
+		typename Map::const_iterator it = map.find(i);
+		if (it == map.cend() || it->second != i) {
+			return false;
+		}
+	}
+	return map.size() == static_cast<size_t>(n) && map.find(n) == map.cend() && map.find(-1) == map.cend();
+}
+
+//	a node for driving an engine's index directly
+struct bare_node : sjtu::swiss_groups::node_base<bare_node> {
+	int key;
+};
+
+typedef sjtu::swiss_groups::index<bare_node> swiss_index;
+
+struct bare_hash {
+	size_t operator()(const bare_node *node) const {
+		return std::hash<int>()(node->key);
+	}
+};
+
+//	the first n nodes are found, and the keys from n up to missing are not
+bool finds(const swiss_index &index, const std::vector<bare_node> &nodes, size_t n, int missing) {
+	for (size_t i = 0; i < n; ++i) {
+		const bare_node *node = &nodes[i];
+		if (index.find(std::hash<int>()(node->key), [node](const bare_node *other) { return other == node; }) != node) {
+			return false;
+		}
+	}
+	for (int key = static_cast<int>(n); key < missing; ++key) {
+		if (index.find(std::hash<int>()(key), [key](const bare_node *other) { return other->key == key; })) {
+			return false;
+		}
+	}
+	return true;
+}
+
+//	test: a Swiss table always leaves probes somewhere to stop
+void swiss_limits() {
+	swiss_index index(1);
+	size_t slots = index.bucket_count();
+	std::vector<bare_node> nodes(slots);
+	for (size_t i = 0; i < slots; ++i) {
+		nodes[i].key = static_cast<int>(i);
+	}
+	//	filled up to its ceiling, then one short of full
+	size_t inserted = 0;
+	for (; inserted < index.load_limit(1.0f); ++inserted) {
+		index.insert(&nodes[inserted], std::hash<int>()(nodes[inserted].key));
+	}
+	bool at_ceiling = inserted == slots - slots / 8;
+	index.rehash(1, bare_hash());
+	bool kept = index.bucket_count() == slots && finds(index, nodes, inserted, 4 * static_cast<int>(slots));
+	for (; inserted + 1 < slots; ++inserted) {
+		index.insert(&nodes[inserted], std::hash<int>()(nodes[inserted].key));
+	}
+	//	a rehash to any count grows the table until an eighth is EMPTY
+	index.rehash(1, bare_hash());
+	bool grown = index.bucket_count() - index.bucket_count() / 8 >= inserted
+		&& finds(index, nodes, inserted, 4 * static_cast<int>(slots));
+	std::cout << at_ceiling << kept << grown << " ";
+	//	a table with no EMPTY slot at all still answers a miss
+	swiss_index full(1);
+	for (size_t i = 0; i < slots; ++i) {
+		full.insert(&nodes[i], std::hash<int>()(nodes[i].key));
+	}
+	std::cout << finds(full, nodes, slots, 4 * static_cast<int>(slots)) << " ";
+	//	through the map: max_load_factor(1), then rehash() to the minimum
+	map_of<sjtu::swiss_groups> map;
+	for (int i = 0; i < 1000; ++i) {
+		map[i] = i;
+	}
+	map.max_load_factor(1.0f);
+	map.rehash(0);
+	bool rehashed = holds(map, 1000);
+	for (int i = 1000; i < 2000; ++i) {
+		map[i] = i;
+	}
+	std::cout << rehashed << holds(map, 2000) << (map.size() < map.bucket_count()) << std::endl;
+}
+
+//	test: sizing the index from max_load_factor() alone must not fill an
+//	engine past its own ceiling, neither when rehashing nor when reserving
+//	nor when a small map builds its first index
+template<class Engine>
+void beyond_ceiling(const char *name) {
+	map_of<Engine> map;
+	for (int i = 0; i < 16; ++i) {
+		map[i] = i;
+	}
+	map.max_load_factor(1.0f);
+	map.rehash(0);
+	bool rehashed = holds(map, 16);
+	map_of<Engine> reserved;
+	reserved.max_load_factor(1.0f);
+	reserved.reserve(1000);
+	size_t buckets = reserved.bucket_count();
+	for (int i = 0; i < 1000; ++i) {
+		reserved[i] = i;
+	}
+	bool filled = holds(reserved, 1000) && reserved.bucket_count() == buckets;
+	map_of<Engine> raised;
+	for (int i = 0; i < 500; ++i) {
+		raised[i] = i;
+	}
+	raised.max_load_factor(4.0f);
+	raised.rehash(0);
+	bool loaded = holds(raised, 500);
+	raised.shrink_to_fit();
+	bool shrunk = holds(raised, 500);
+	map_of<Engine> small;
+	small.max_load_factor(4.0f);
+	for (int i = 0; i < 8; ++i) {
+		small[i] = i;
+	}
+	small.rehash(0);
+	std::cout << name << " " << rehashed << filled << loaded << shrunk << holds(small, 8) << std::endl;
+}
+
+void tester(void) {
+	swiss_limits();
+	beyond_ceiling<sjtu::chained_buckets<> >("chained");
+	beyond_ceiling<sjtu::chained_buckets<sjtu::prime_modulo> >("prime");
+	beyond_ceiling<sjtu::incremental_chained<> >("incremental");
+	beyond_ceiling<sjtu::treeified_buckets<> >("treeified");
+	beyond_ceiling<sjtu::open_addressing<> >("open");
+	beyond_ceiling<sjtu::open_addressing<sjtu::prime_modulo> >("open_prime");
+	beyond_ceiling<sjtu::swiss_groups>("swiss");
+}
+
+int main() {
+	tester();
+	return 0;
+}
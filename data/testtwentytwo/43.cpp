@@ -0,0 +1,207 @@
+#include "linked_hashmap.hpp"
+#include <iostream>
+#include <list>
+#include <map>
+#include <string>
+
+//	counts its calls, to show that erasing a run hashes nothing
+static size_t hash_calls = 0;
+
+struct counted_hash {
+	size_t operator()(const std::string &key) const {
+		++hash_calls;
+		return std::hash<std::string>()(key);
+	}
+};
+
+typedef sjtu::linked_hashmap<std::string, int, counted_hash> string_map;
+typedef sjtu::linked_hashmap<int, int> map_type;
+
+template<class Map>
+void print(const Map &map) {
+	std::cout << map.size() << ":";
+	for (typename Map::const_iterator it = map.cbegin(); it != map.cend(); ++it) {
+		std::cout << " " << it->first;
+	}
+	std::cout << std::endl;
+}
+
+//	every element can still be found, and nothing else
+bool consistent(const map_type &map, int limit) {
+	size_t found = 0;
+	for (int key = 0; key < limit; ++key) {
+		map_type::const_iterator it = map.find(key);
+		if (it != map.cend()) {
+			if (it->first != key) {
+				return false;
+			}
+			++found;
+		}
+	}
+	return found == map.size();
+}
+
+template<class F>
+bool throws(F f) {
+	try {
+		f();
+	} catch (sjtu::invalid_iterator &) {
+		return true;
+	}
+	return false;
+}
+
+//	random batch erasures against a list and a map that mirror the order
+bool against_reference() {
+	map_type map;
+	std::list<int> order;
+	std::map<int, std::list<int>::iterator> where;
+	unsigned long long state = 43;
+	for (int step = 0; step < 20000; ++step) {
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		int key = static_cast<int>(state >> 33) % 5000;
+		int op = static_cast<int>(state >> 24) % 8;
+		if (op < 5) {
+			if (!map.count(key)) {
+				map[key] = step;
+				where[key] = order.insert(order.end(), key);
+			}
+		} else if (op == 5) {
+			size_t n = static_cast<size_t>(key % 40);
+			if (map.pop_front(n) != (n < order.size() ? n : order.size())) {
+				return false;
+			}
+			for (size_t i = 0; i < n && !order.empty(); ++i) {
+				where.erase(order.front());
+				order.pop_front();
+			}
+		} else if (op == 6 && where.count(key)) {
+			map_type::iterator first = map.find(key), last = first;
+			std::list<int>::iterator expected = where[key];
+			for (int i = 0; i < key % 30 && last != map.end(); ++i, ++expected) {
+				++last;
+			}
+			std::list<int>::iterator drop = where[key];
+			while (drop != expected) {
+				where.erase(*drop);
+				drop = order.erase(drop);
+			}
+			if (map.erase_range(first, last) != last) {
+				return false;
+			}
+		} else if (op == 7 && where.count(key)) {
+			std::list<int>::iterator stop = where[key];
+			size_t n = 0;
+			while (order.begin() != stop) {
+				where.erase(order.front());
+				order.pop_front();
+				++n;
+			}
+			if (map.erase_older_than(map.find(key)) != n) {
+				return false;
+			}
+		}
+		if (map.size() != order.size()) {
+			return false;
+		}
+	}
+	std::list<int>::iterator expected = order.begin();
+	for (map_type::iterator it = map.begin(); it != map.end(); ++it, ++expected) {
+		if (it->first != *expected) {
+			return false;
+		}
+	}
+	return consistent(map, 5000);
+}
+
+void tester(void) {
+	//	test: pop_front(n) takes the n oldest elements, or all of them
+	map_type map;
+	for (int i = 0; i < 20; ++i) {
+		map[i] = i;
+	}
+	std::cout << map.pop_front(0) << " " << map.pop_front(3) << " ";
+	print(map);
+	map.move_to_back(map.find(3));
+	std::cout << map.pop_front(2) << " " << map.count(3) << " " << map.count(4) << " " << map.count(5) << " " << map.pop_front(100)
+		<< " " << map.pop_front(1) << " ";
+	print(map);
+	//	test: erase_range() cuts a run out of the middle, and returns its end
+	for (int i = 0; i < 1000; ++i) {
+		map[i] = i;
+	}
+	map_type::iterator first = map.find(10), last = map.find(990);
+	map_type::iterator next = map.erase_range(first, last);
+	std::cout << map.size() << " " << next->first << " " << (--next)->first << " " << consistent(map, 1000) << " ";
+	map_type::iterator tail = map.erase_range(map.find(995), map.end());
+	std::cout << (tail == map.end()) << " " << map.erase_range(map.begin(), map.begin())->first << " ";
+	print(map);
+	//	test: erase_older_than() expires the front, end() expires everything
+	for (int i = 100; i < 200; ++i) {
+		map[i] = i;
+	}
+	std::cout << map.erase_older_than(map.begin()) << " " << map.erase_older_than(map.find(150)) << " " << map.begin()->first
+		<< " " << consistent(map, 1000) << " " << map.erase_older_than(map.end()) << " " << map.empty() << " "
+		<< map.erase_older_than(map.end()) << std::endl;
+	//	test: iterators of another map are refused
+	map_type other;
+	other[1] = 1;
+	for (int i = 0; i < 5; ++i) {
+		map[i] = i;
+	}
+	std::cout << throws([&]() { map.erase_range(other.begin(), map.end()); }) << " "
+		<< throws([&]() { map.erase_range(map.begin(), other.end()); }) << " "
+		<< throws([&]() { map.erase_older_than(other.begin()); }) << " " << map.size() << std::endl;
+	//	test: erasing a run of cached hashes hashes nothing
+	string_map words;
+	for (int i = 0; i < 1000; ++i) {
+		words["word" + std::to_string(i)] = i;
+	}
+	hash_calls = 0;
+	size_t popped = words.pop_front(300);
+	int after = words.erase_range(words.begin(), std::next(words.begin(), 200))->second;
+	size_t older = words.erase_older_than(std::next(words.begin(), 100));
+	size_t calls = hash_calls;
+	std::cout << popped << " " << after << " " << older << " " << calls << " " << words.size() << " "
+		<< words.count("word599") << words.count("word600") << std::endl;
+	//	test: a scan resumes at the key it stopped at, and sees new elements
+	for (int i = 0; i < 10; ++i) {
+		map[i] = i * i;
+	}
+	int seen = 0, resume = -1;
+	for (const map_type::value_type &value : map.iterate_from(0)) {
+		if (++seen == 4) {
+			resume = value.first;
+			break;
+		}
+	}
+	map[42] = 42;
+	std::cout << resume << ":";
+	for (map_type::value_type &value : map.iterate_from(resume)) {
+		std::cout << " " << value.first << "=" << value.second;
+		value.second = -value.second;
+	}
+	const map_type &view = map;
+	std::cout << " |";
+	for (const map_type::value_type &value : view.iterate_from(8)) {
+		std::cout << " " << value.second;
+	}
+	std::cout << " | " << (map.iterate_from(1000).begin() == map.end()) << std::endl;
+	//	test: with min_load_factor(), a big cut shrinks the index once
+	map_type sparse;
+	sparse.min_load_factor(0.1f);
+	for (int i = 0; i < 100000; ++i) {
+		sparse[i] = i;
+	}
+	size_t buckets = sparse.bucket_count();
+	sparse.pop_front(99000);
+	std::cout << sparse.size() << " " << (sparse.bucket_count() * 16 < buckets) << " " << sparse.begin()->first << " "
+		<< sparse.count(98999) << sparse.count(99000) << std::endl;
+	//	test: random runs, against a list and a map
+	std::cout << against_reference() << std::endl;
+}
+
+int main() {
+	tester();
+	return 0;
+}
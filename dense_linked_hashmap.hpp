@@ -0,0 +1,858 @@
+/**
+ * a linked_hashmap whose entries are stored densely in insertion order
+ */
+#ifndef SJTU_DENSE_LINKED_HASHMAP_HPP
+#define SJTU_DENSE_LINKED_HASHMAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <cmath>
+#include "linked_hashmap.hpp"
+
+namespace sjtu {
+    /**
+     * dense_linked_hashmap has the interface and the iteration order of
+     * linked_hashmap, laid out like the dict of Python 3.6+: the entries
+     * sit in one array in insertion order, and a sparse table of 32-bit
+     * entry indices finds them by hash (linear probing).
+     *
+     * Insertion appends to the array, so the order needs no links and a
+     * full iteration streams through contiguous memory. Erasing an entry
+     * destroys its element and leaves a dead entry (a tombstone) in the
+     * array; its index slot becomes DELETED and is reused by a later
+     * insertion that probes past it. The array is compacted, together
+     * with a rebuild of the index, by the insertion that finds
+     *   - the array full with at least a quarter of it dead, or
+     *   - more dead entries than live ones,
+     * and grows to twice its size when it is full otherwise. Iteration
+     * thus never crosses more dead entries than live ones for long.
+     *
+     * Unlike linked_hashmap, elements move when the array is compacted or
+     * grows. Any insertion, and rehash(), reserve() and max_load_factor(),
+     * may therefore invalidate every iterator and reference, as for a
+     * std::vector; erase() only invalidates those to the erased element.
+     * Elements are moved if that cannot throw and copied otherwise, so a
+     * failed relocation leaves the map unchanged. At most 2^32 - 2
+     * entries fit; inserting beyond that throws runtime_error.
+     */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>,
+	class Allocator = std::allocator<pair<const Key, T> >,
+	class Indexing = power_of_two_mix
+> class dense_linked_hashmap {
+public:
+	typedef pair<const Key, T> value_type;
+
+private:
+	typedef std::uint32_t link;
+	static const link EMPTY = 0xffffffffu;
+	static const link DELETED = 0xfffffffeu;
+
+	typedef cache_hash<Key, Hash> hash_cached;
+
+	// an element of the dense array, or a tombstone if !live
+	struct Entry : node_hash<hash_cached::value> {
+		alignas(value_type) unsigned char storage[sizeof(value_type)];
+		bool live;
+
+		value_type & data() {
+			return *reinterpret_cast<value_type *>(storage);
+		}
+
+		const value_type & data() const {
+			return *reinterpret_cast<const value_type *>(storage);
+		}
+	};
+
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Entry> entry_allocator;
+	typedef std::allocator_traits<entry_allocator> entry_traits;
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<link> link_allocator;
+	typedef std::allocator_traits<link_allocator> link_traits;
+
+	// a move copies the hasher, key_equal and allocators, which the
+	// moved-from map keeps; everything else is only swapped. swap() moves
+	// Hash and Equal through std::swap, and allocators never throw on swap.
+	typedef std::integral_constant<bool, std::is_nothrow_copy_constructible<Hash>::value
+		&& std::is_nothrow_copy_constructible<Equal>::value
+		&& std::is_nothrow_copy_constructible<entry_allocator>::value
+		&& std::is_nothrow_copy_constructible<link_allocator>::value> nothrow_move;
+	typedef std::integral_constant<bool, std::is_nothrow_move_constructible<Hash>::value
+		&& std::is_nothrow_move_assignable<Hash>::value && std::is_nothrow_move_constructible<Equal>::value
+		&& std::is_nothrow_move_assignable<Equal>::value> nothrow_swap;
+
+	static const size_t INITIAL_CAPACITY = 16;
+	static const float LOAD_FACTOR;
+
+	Entry* entries;
+	size_t entry_total; // capacity of the dense array
+	size_t used; // entries appended so far, live or dead
+	size_t first; // no live entry before this one
+
+	link* slots;
+	size_t slot_total;
+	Indexing bucket_of;
+
+	size_t element_count;
+	float max_load;
+
+	Hash hasher;
+	Equal key_equal;
+	entry_allocator entry_alloc;
+	link_allocator link_alloc;
+
+	value_type & value_of(link id) const {
+		return entries[id].data();
+	}
+
+	// Hash helpers, as in linked_hashmap
+	template<class K>
+	size_t hash_key(const K& key) const {
+		return hasher(key);
+	}
+
+	size_t hash_of(const Entry& e) const {
+		return entry_hash_of(e, hash_cached());
+	}
+
+	size_t entry_hash_of(const Entry& e, std::true_type) const {
+		return e.hash;
+	}
+
+	size_t entry_hash_of(const Entry& e, std::false_type) const {
+		return hasher(e.data().first);
+	}
+
+	void store_hash(Entry& e, size_t hash, std::true_type) {
+		e.hash = hash;
+	}
+
+	void store_hash(Entry&, size_t, std::false_type) {}
+
+	void copy_hash(Entry& e, const Entry& o, std::true_type) {
+		e.hash = o.hash;
+	}
+
+	void copy_hash(Entry&, const Entry&, std::false_type) {}
+
+	bool same_hash(const Entry& e, size_t hash, std::true_type) const {
+		return e.hash == hash;
+	}
+
+	bool same_hash(const Entry&, size_t, std::false_type) const {
+		return true;
+	}
+
+	// Index
+	size_t next_slot(size_t i) const {
+		return i + 1 == slot_total ? 0 : i + 1;
+	}
+
+	// the dense array may hold this many entries for a given slot count;
+	// one slot at least stays EMPTY, so every probe ends
+	size_t capacity_for(size_t slot_count) const {
+		size_t limit = static_cast<size_t>(slot_count * max_load);
+		if (limit >= slot_count) {
+			limit = slot_count - 1;
+		}
+		return limit < DELETED ? limit : DELETED;
+	}
+
+	size_t slots_for(size_t n) const {
+		size_t wanted = static_cast<size_t>(std::ceil(n / static_cast<double>(max_load)));
+		return wanted > n ? wanted : n + 1;
+	}
+
+	template<class K>
+	link find_id(const K& key, size_t hash) const {
+		if (!slot_total) {
+			return EMPTY;
+		}
+		for (size_t i = bucket_of(hash);; i = next_slot(i)) {
+			link id = slots[i];
+			if (id == EMPTY) {
+				return EMPTY;
+			}
+			if (id != DELETED) {
+				const Entry& e = entries[id];
+				if (same_hash(e, hash, hash_cached()) && key_equal(e.data().first, key)) {
+					return id;
+				}
+			}
+		}
+	}
+
+	// the slot a new entry of this hash goes to
+	size_t free_slot(size_t hash) const {
+		size_t i = bucket_of(hash);
+		while (slots[i] != EMPTY && slots[i] != DELETED) {
+			i = next_slot(i);
+		}
+		return i;
+	}
+
+	size_t slot_of(link id, size_t hash) const {
+		size_t i = bucket_of(hash);
+		while (slots[i] != id) {
+			i = next_slot(i);
+		}
+		return i;
+	}
+
+	// Storage
+	void allocate(size_t slot_count) {
+		slot_total = Indexing::round(slot_count);
+		slots = link_traits::allocate(link_alloc, slot_total);
+		entry_total = capacity_for(slot_total);
+		try {
+			entries = entry_traits::allocate(entry_alloc, entry_total);
+		} catch (...) {
+			link_traits::deallocate(link_alloc, slots, slot_total);
+			throw;
+		}
+		for (size_t i = 0; i < slot_total; ++i) {
+			slots[i] = EMPTY;
+		}
+		bucket_of.resize(slot_total);
+	}
+
+	void deallocate() {
+		deallocate(entries, entry_total, slots, slot_total);
+	}
+
+	// a moved-from map has neither array
+	void deallocate(Entry* old_entries, size_t old_entry_total, link* old_slots, size_t old_slot_total) {
+		if (old_slots) {
+			entry_traits::deallocate(entry_alloc, old_entries, old_entry_total);
+			link_traits::deallocate(link_alloc, old_slots, old_slot_total);
+		}
+	}
+
+	// the state a map is left in by a move: empty, and without arrays
+	void reset_unallocated() {
+		entries = nullptr;
+		entry_total = 0;
+		slots = nullptr;
+		slot_total = 0;
+		reset_empty();
+	}
+
+	void destroy_elements() {
+		if (!std::is_trivially_destructible<value_type>::value) {
+			for (size_t id = first; id < used; ++id) {
+				if (entries[id].live) {
+					entries[id].data().~value_type();
+				}
+			}
+		}
+	}
+
+	void reset_empty() {
+		used = 0;
+		first = 0;
+		element_count = 0;
+	}
+
+	/**
+	 * moves the live entries, in order and without tombstones, into a
+	 * fresh array for about slot_count slots and rebuilds the index.
+	 * Leaves the map unchanged if an element cannot be moved.
+	 */
+	void relocate(size_t slot_count) {
+		Entry* old_entries = entries;
+		size_t old_entry_total = entry_total;
+		link* old_slots = slots;
+		size_t old_slot_total = slot_total;
+		Indexing old_bucket_of = bucket_of;
+		allocate(slot_count);
+		size_t moved = 0;
+		try {
+			for (size_t id = first; id < used; ++id) {
+				Entry& o = old_entries[id];
+				if (!o.live) {
+					continue;
+				}
+				Entry& e = entries[moved];
+				::new (static_cast<void *>(e.storage)) value_type(std::move_if_noexcept(o.data()));
+				e.live = true;
+				copy_hash(e, o, hash_cached());
+				slots[free_slot(hash_of(e))] = static_cast<link>(moved);
+				++moved;
+			}
+		} catch (...) {
+			for (size_t id = 0; id < moved; ++id) {
+				entries[id].data().~value_type();
+			}
+			deallocate();
+			entries = old_entries;
+			entry_total = old_entry_total;
+			slots = old_slots;
+			slot_total = old_slot_total;
+			bucket_of = old_bucket_of;
+			throw;
+		}
+		if (!std::is_trivially_destructible<value_type>::value) {
+			for (size_t id = first; id < used; ++id) {
+				if (old_entries[id].live) {
+					old_entries[id].data().~value_type();
+				}
+			}
+		}
+		deallocate(old_entries, old_entry_total, old_slots, old_slot_total);
+		used = moved;
+		first = 0;
+	}
+
+	// the slot count to relocate to before entries[used] can take one more
+	// entry, or 0 if it already can
+	size_t room_target() const {
+		size_t dead = used - element_count;
+		if (!slot_total) {
+			return INITIAL_CAPACITY;
+		}
+		if (used == entry_total) {
+			if (dead * 4 < used) {
+				if (entry_total == DELETED) {
+					throw runtime_error();
+				}
+				return slot_total * 2;
+			}
+			return slot_total;
+		}
+		return dead > element_count ? slot_total : 0;
+	}
+
+	// builds entries[used] from args and indexes it; room must be made first
+	template<class... Args>
+	link append(size_t hash, Args&&... args) {
+		Entry& e = entries[used];
+		::new (static_cast<void *>(e.storage)) value_type(std::forward<Args>(args)...);
+		e.live = true;
+		store_hash(e, hash, hash_cached());
+		link id = static_cast<link>(used++);
+		slots[free_slot(hash)] = id;
+		++element_count;
+		return id;
+	}
+
+	// inserts an element built from args unless key is present; returns
+	// the entry holding key and whether it is new
+	template<class... Args>
+	pair<link, bool> emplace_unique(const Key& key, Args&&... args) {
+		size_t hash = hash_key(key);
+		link existing = find_id(key, hash);
+		if (existing != EMPTY) {
+			return pair<link, bool>(existing, false);
+		}
+		size_t target = room_target();
+		if (!target) {
+			return pair<link, bool>(append(hash, std::forward<Args>(args)...), true);
+		}
+		// args may refer into entries, which relocate() frees, so the
+		// element is built before it and moved in after
+		value_type value(std::forward<Args>(args)...);
+		relocate(target);
+		return pair<link, bool>(append(hash, std::move(value)), true);
+	}
+
+	void erase_id(link id) {
+		Entry& e = entries[id];
+		slots[slot_of(id, hash_of(e))] = DELETED;
+		e.data().~value_type();
+		e.live = false;
+		--element_count;
+		while (first < used && !entries[first].live) {
+			++first;
+		}
+	}
+
+	// the first live entry from id on, or EMPTY
+	link next_live(size_t id) const {
+		while (id < used && !entries[id].live) {
+			++id;
+		}
+		return id < used ? static_cast<link>(id) : EMPTY;
+	}
+
+	// the last live entry before id, or EMPTY
+	link prev_live(size_t id) const {
+		while (id > first) {
+			--id;
+			if (entries[id].live) {
+				return static_cast<link>(id);
+			}
+		}
+		return EMPTY;
+	}
+
+	// takes over the array, tombstones included, and the index of other
+	void clone_from(const dense_linked_hashmap& other) {
+		size_t id = other.first;
+		try {
+			for (; id < other.used; ++id) {
+				Entry& e = entries[id];
+				const Entry& o = other.entries[id];
+				e.live = o.live;
+				if (o.live) {
+					::new (static_cast<void *>(e.storage)) value_type(o.data());
+					copy_hash(e, o, hash_cached());
+				}
+			}
+		} catch (...) {
+			for (size_t done = other.first; done < id; ++done) {
+				if (entries[done].live) {
+					entries[done].data().~value_type();
+				}
+			}
+			throw;
+		}
+		for (size_t i = 0; i < other.slot_total; ++i) {
+			slots[i] = other.slots[i];
+		}
+		used = other.used;
+		first = other.first;
+		element_count = other.element_count;
+	}
+
+public:
+	class const_iterator;
+	class iterator {
+	private:
+		link current;
+		dense_linked_hashmap* container;
+
+		friend class dense_linked_hashmap;
+		friend class const_iterator;
+
+		iterator(link current, dense_linked_hashmap* container) : current(current), container(container) {}
+
+	public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = typename dense_linked_hashmap::value_type;
+		using pointer = value_type*;
+		using reference = value_type&;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+		iterator() : current(EMPTY), container(nullptr) {}
+
+		iterator operator++(int) {
+			iterator temp = *this;
+			++*this;
+			return temp;
+		}
+
+		iterator & operator++() {
+			if (current == EMPTY) {
+				throw invalid_iterator();
+			}
+			current = container->next_live(current + 1);
+			return *this;
+		}
+
+		iterator operator--(int) {
+			iterator temp = *this;
+			--*this;
+			return temp;
+		}
+
+		iterator & operator--() {
+			if (!container) {
+				throw invalid_iterator();
+			}
+			link prev = container->prev_live(current != EMPTY ? current : container->used);
+			if (prev == EMPTY) {
+				throw invalid_iterator();
+			}
+			current = prev;
+			return *this;
+		}
+
+		value_type & operator*() const {
+			return container->value_of(current);
+		}
+
+		value_type* operator->() const noexcept {
+			return &container->value_of(current);
+		}
+
+		bool operator==(const iterator &rhs) const {
+			return current == rhs.current && container == rhs.container;
+		}
+
+		bool operator==(const const_iterator &rhs) const {
+			return current == rhs.current && container == rhs.container;
+		}
+
+		bool operator!=(const iterator &rhs) const {
+			return !(*this == rhs);
+		}
+
+		bool operator!=(const const_iterator &rhs) const {
+			return !(*this == rhs);
+		}
+	};
+
+	class const_iterator {
+	private:
+		link current;
+		const dense_linked_hashmap* container;
+
+		friend class dense_linked_hashmap;
+		friend class iterator;
+
+		const_iterator(link current, const dense_linked_hashmap* container) : current(current), container(container) {}
+
+	public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = const typename dense_linked_hashmap::value_type;
+		using pointer = value_type*;
+		using reference = value_type&;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+		const_iterator() : current(EMPTY), container(nullptr) {}
+
+		const_iterator(const iterator &other) : current(other.current), container(other.container) {}
+
+		const_iterator operator++(int) {
+			const_iterator temp = *this;
+			++*this;
+			return temp;
+		}
+
+		const_iterator & operator++() {
+			if (current == EMPTY) {
+				throw invalid_iterator();
+			}
+			current = container->next_live(current + 1);
+			return *this;
+		}
+
+		const_iterator operator--(int) {
+			const_iterator temp = *this;
+			--*this;
+			return temp;
+		}
+
+		const_iterator & operator--() {
+			if (!container) {
+				throw invalid_iterator();
+			}
+			link prev = container->prev_live(current != EMPTY ? current : container->used);
+			if (prev == EMPTY) {
+				throw invalid_iterator();
+			}
+			current = prev;
+			return *this;
+		}
+
+		const value_type & operator*() const {
+			return container->value_of(current);
+		}
+
+		const value_type* operator->() const noexcept {
+			return &container->value_of(current);
+		}
+
+		bool operator==(const const_iterator &rhs) const {
+			return current == rhs.current && container == rhs.container;
+		}
+
+		bool operator==(const iterator &rhs) const {
+			return current == rhs.current && container == rhs.container;
+		}
+
+		bool operator!=(const const_iterator &rhs) const {
+			return !(*this == rhs);
+		}
+
+		bool operator!=(const iterator &rhs) const {
+			return !(*this == rhs);
+		}
+	};
+
+	dense_linked_hashmap() : dense_linked_hashmap(INITIAL_CAPACITY) {}
+
+	/**
+	 * constructs an empty map with at least bucket_count index slots.
+	 */
+	explicit dense_linked_hashmap(size_t bucket_count, const Hash &hash = Hash(), const Equal &equal = Equal(),
+		const Allocator &allocator = Allocator())
+		: max_load(LOAD_FACTOR), hasher(hash), key_equal(equal), entry_alloc(allocator), link_alloc(allocator) {
+		reset_empty();
+		allocate(bucket_count);
+	}
+
+	dense_linked_hashmap(const dense_linked_hashmap &other)
+		: max_load(other.max_load), hasher(other.hasher), key_equal(other.key_equal),
+		entry_alloc(entry_traits::select_on_container_copy_construction(other.entry_alloc)),
+		link_alloc(link_traits::select_on_container_copy_construction(other.link_alloc)) {
+		reset_empty();
+		allocate(other.slot_total);
+		try {
+			clone_from(other);
+		} catch (...) {
+			deallocate();
+			throw;
+		}
+	}
+
+	/**
+	 * takes over the elements and arrays of other, which is left empty
+	 * with no arrays at all until its next insertion.
+	 */
+	dense_linked_hashmap(dense_linked_hashmap &&other) noexcept(nothrow_move::value)
+		: max_load(other.max_load), hasher(other.hasher), key_equal(other.key_equal),
+		entry_alloc(other.entry_alloc), link_alloc(other.link_alloc) {
+		reset_unallocated();
+		swap(other);
+	}
+
+	dense_linked_hashmap & operator=(const dense_linked_hashmap &other) {
+		if (this != &other) {
+			dense_linked_hashmap temp(other);
+			swap(temp);
+		}
+		return *this;
+	}
+
+	dense_linked_hashmap & operator=(dense_linked_hashmap &&other) noexcept(nothrow_move::value && nothrow_swap::value) {
+		if (this != &other) {
+			dense_linked_hashmap temp(std::move(other));
+			swap(temp);
+		}
+		return *this;
+	}
+
+	void swap(dense_linked_hashmap &other) noexcept(nothrow_swap::value) {
+		std::swap(entries, other.entries);
+		std::swap(entry_total, other.entry_total);
+		std::swap(used, other.used);
+		std::swap(first, other.first);
+		std::swap(slots, other.slots);
+		std::swap(slot_total, other.slot_total);
+		std::swap(bucket_of, other.bucket_of);
+		std::swap(element_count, other.element_count);
+		std::swap(max_load, other.max_load);
+		std::swap(hasher, other.hasher);
+		std::swap(key_equal, other.key_equal);
+		using std::swap;
+		swap(entry_alloc, other.entry_alloc);
+		swap(link_alloc, other.link_alloc);
+	}
+
+	~dense_linked_hashmap() {
+		destroy_elements();
+		deallocate();
+	}
+
+	/**
+	 * access specified element with bounds checking.
+	 * throw index_out_of_bound if no such element exists.
+	 */
+	T & at(const Key &key) {
+		link id = find_id(key, hash_key(key));
+		if (id == EMPTY) {
+			throw index_out_of_bound();
+		}
+		return value_of(id).second;
+	}
+
+	const T & at(const Key &key) const {
+		link id = find_id(key, hash_key(key));
+		if (id == EMPTY) {
+			throw index_out_of_bound();
+		}
+		return value_of(id).second;
+	}
+
+	/**
+	 * access specified element, inserting a value-initialized one if
+	 * key does not exist.
+	 */
+	T & operator[](const Key &key) {
+		return value_of(emplace_unique(key, std::piecewise_construct,
+			std::forward_as_tuple(key), std::tuple<>()).first).second;
+	}
+
+	/**
+	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 */
+	const T & operator[](const Key &key) const {
+		return at(key);
+	}
+
+	/**
+	 * at() without the exception: a pointer to the value mapped to key,
+	 * or nullptr if there is none.
+	 */
+	T * get(const Key &key) {
+		link id = find_id(key, hash_key(key));
+		return id == EMPTY ? nullptr : &value_of(id).second;
+	}
+
+	const T * get(const Key &key) const {
+		link id = find_id(key, hash_key(key));
+		return id == EMPTY ? nullptr : &value_of(id).second;
+	}
+
+	/**
+	 * copies the value mapped to key into out. returns false, leaving out
+	 * alone, if key is not present.
+	 */
+	bool try_get(const Key &key, T &out) const {
+		const T *value = get(key);
+		if (!value) {
+			return false;
+		}
+		out = *value;
+		return true;
+	}
+
+	iterator begin() {
+		return iterator(next_live(first), this);
+	}
+
+	const_iterator cbegin() const {
+		return const_iterator(next_live(first), this);
+	}
+
+	iterator end() {
+		return iterator(EMPTY, this);
+	}
+
+	const_iterator cend() const {
+		return const_iterator(EMPTY, this);
+	}
+
+	bool empty() const {
+		return element_count == 0;
+	}
+
+	size_t size() const {
+		return element_count;
+	}
+
+	size_t bucket_count() const {
+		return slot_total;
+	}
+
+	float load_factor() const {
+		if (!slot_total) {
+			return 0;
+		}
+		return static_cast<float>(element_count) / slot_total;
+	}
+
+	float max_load_factor() const {
+		return max_load;
+	}
+
+	/**
+	 * throw runtime_error unless ml > 0
+	 */
+	void max_load_factor(float ml) {
+		if (!(ml > 0)) {
+			throw runtime_error();
+		}
+		max_load = ml;
+		if (used > capacity_for(slot_total)) {
+			relocate(slots_for(element_count));
+		}
+	}
+
+	/**
+	 * rebuilds the index with at least count slots; compacts the array
+	 */
+	void rehash(size_t count) {
+		size_t needed = slots_for(element_count);
+		relocate(count > needed ? count : needed);
+	}
+
+	void reserve(size_t count) {
+		if (count > entry_total) {
+			relocate(slots_for(count));
+		}
+	}
+
+	/**
+	 * clears the contents; the array and the index are kept for reuse.
+	 */
+	void clear() {
+		destroy_elements();
+		reset_empty();
+		for (size_t i = 0; i < slot_total; ++i) {
+			slots[i] = EMPTY;
+		}
+	}
+
+	pair<iterator, bool> insert(const value_type &value) {
+		pair<link, bool> result = emplace_unique(value.first, value);
+		return pair<iterator, bool>(iterator(result.first, this), result.second);
+	}
+
+	pair<iterator, bool> insert(value_type &&value) {
+		pair<link, bool> result = emplace_unique(value.first, std::move(value));
+		return pair<iterator, bool>(iterator(result.first, this), result.second);
+	}
+
+	template<class... Args>
+	pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+		pair<link, bool> result = emplace_unique(key, std::piecewise_construct,
+			std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		return pair<iterator, bool>(iterator(result.first, this), result.second);
+	}
+
+	template<class M>
+	pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+		pair<iterator, bool> result = try_emplace(key, std::forward<M>(obj));
+		if (!result.second) {
+			result.first->second = std::forward<M>(obj);
+		}
+		return result;
+	}
+
+	/**
+	 * throw invalid_iterator if pos is end() or belongs to another map
+	 */
+	void erase(iterator pos) {
+		if (pos.container != this || pos.current == EMPTY) {
+			throw invalid_iterator();
+		}
+		erase_id(pos.current);
+	}
+
+	size_t erase(const Key &key) {
+		link id = find_id(key, hash_key(key));
+		if (id == EMPTY) {
+			return 0;
+		}
+		erase_id(id);
+		return 1;
+	}
+
+	size_t count(const Key &key) const {
+		return find_id(key, hash_key(key)) != EMPTY ? 1 : 0;
+	}
+
+	iterator find(const Key &key) {
+		return iterator(find_id(key, hash_key(key)), this);
+	}
+
+	const_iterator find(const Key &key) const {
+		return const_iterator(find_id(key, hash_key(key)), this);
+	}
+};
+
+template<class Key, class T, class Hash, class Equal, class Allocator, class Indexing>
+const float dense_linked_hashmap<Key, T, Hash, Equal, Allocator, Indexing>::LOAD_FACTOR = 0.75f;
+
+}
+
+#endif
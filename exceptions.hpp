@@ -7,15 +7,18 @@
 
 namespace sjtu {
 
+// variant and detail point to string literals, so that making or
+// copying an exception never allocates; what() builds its string only
+// when asked.
 class exception {
 protected:
-	const std::string variant = "";
-	std::string detail = "";
+	const char *variant = "";
+	const char *detail = "";
 public:
-	exception() {}
-	exception(const exception &ec) : variant(ec.variant), detail(ec.detail) {}
+	exception() noexcept {}
+	exception(const exception &ec) noexcept : variant(ec.variant), detail(ec.detail) {}
 	virtual std::string what() {
-		return variant + " " + detail;
+		return std::string(variant) + " " + detail;
 	}
 };
 
@@ -7,503 +7,4261 @@
 // only for std::equal_to<T> and std::hash<T>
 #include <functional>
 #include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <exception>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <cstdint>
+#if defined(__AVX2__) && !defined(SJTU_LINKED_HASHMAP_NO_SIMD)
+#include <immintrin.h>
+#elif defined(__SSE2__) && !defined(SJTU_LINKED_HASHMAP_NO_SIMD)
+#include <emmintrin.h>
+#endif
+#include <iterator>
+#include <string>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define SJTU_LINKED_HASHMAP_PREFETCH(address) __builtin_prefetch(address)
+#else
+#define SJTU_LINKED_HASHMAP_PREFETCH(address) ((void)(address))
+#endif
+
+// Define SJTU_LINKED_HASHMAP_CHAIN_PREFETCH to prefetch one node ahead
+// while walking bucket chains and the insertion list (find(), iterator
+// increments, clear()). It pays off on maps far larger than the cache
+// and costs a few instructions per step on small ones.
+#ifdef SJTU_LINKED_HASHMAP_CHAIN_PREFETCH
+#define SJTU_LINKED_HASHMAP_CHAIN_HINT(address) SJTU_LINKED_HASHMAP_PREFETCH(address)
+#else
+#define SJTU_LINKED_HASHMAP_CHAIN_HINT(address) ((void)0)
+#endif
+
+// SJTU_LINKED_HASHMAP_ITERATOR_CHECKS sets, at compile time, how much the
+// iterators of linked_hashmap check; it must be the same in every
+// translation unit.
+//   0  an iterator is a single pointer and nothing is checked: misuse is
+//      undefined, as with the standard containers, and ordered loops are
+//      plain pointer chasing;
+//   1  (the default) iterators also know their map: ++end(), --begin()
+//      and passing a map an iterator of another map throw
+//      invalid_iterator;
+//   2  as 1, and iterators remember the generation of their element, so
+//      that using one whose element has been erased, extracted or
+//      cleared throws invalid_iterator as well. Erased nodes are kept
+//      for reuse, not freed, until the map is destroyed or assigned to;
+//      iterators into a map that is gone are not checked.
+#ifndef SJTU_LINKED_HASHMAP_ITERATOR_CHECKS
+#define SJTU_LINKED_HASHMAP_ITERATOR_CHECKS 1
+#endif
 #include "utility.hpp"
 #include "exceptions.hpp"
 
 namespace sjtu {
+namespace pool_allocator_detail {
+	struct slab {
+		slab *next;
+		size_t capacity; // in blocks
+	};
+
+	// what every copy of a pool_allocator points to
+	struct pool {
+		size_t users;
+		size_t block; // bytes per block, fixed by the first pooled allocation
+		size_t next_capacity;
+		slab *slabs;
+		void *free_list;
+		unsigned char *cursor; // bump pointer into the newest slab
+		unsigned char *limit;
+		bool in_first_slab; // the pool was allocated together with its oldest slab
+	};
+}
+
     /**
-     * In linked_hashmap, iteration ordering is differ from map,
-     * which is the order in which keys were inserted into the map.
-     * You should maintain a doubly-linked list running through all
-     * of its entries to keep the correct iteration order.
+     * A fixed-size block allocator for the nodes of linked_hashmap.
      *
-     * Note that insertion order is not affected if a key is re-inserted
-     * into the map.
+     * Blocks are carved out of slabs that double in size from 8 blocks,
+     * so a map of a few elements costs one small allocation. deallocate()
+     * pushes the block onto an intrusive free list that the next
+     * allocate() reuses,
+     * so a steady insert/erase churn never reaches the global allocator.
+     * release() hands every slab back at once; it is what clear() and the
+     * destructor of linked_hashmap use instead of freeing node by node.
+     *
+     * Copies, rebound ones included, share one reference-counted pool and
+     * compare equal, so the node handle of extract() and maps built from
+     * one allocator relink nodes between each other instead of
+     * reallocating them. While a pool is shared, unshared() is false and
+     * release() only leaves the pool to the other copies, so maps then
+     * give their nodes back one by one. A copied container gets a pool of
+     * its own (select_on_container_copy_construction). The pool is created
+     * by the first allocation, or by the first copy; blocks are sized for
+     * the first type allocated one at a time, and every other request
+     * goes to the global allocator. Not thread-safe: the copies of one
+     * pool, node handles included, must not be used from several threads
+     * at once.
      */
-    
-template<
-	class Key,
-	class T,
-	class Hash = std::hash<Key>,
-	class Equal = std::equal_to<Key>
-> class linked_hashmap {
-private:
-	// Node structure for hash table buckets and linked list
-	struct Node {
-		pair<const Key, T> data;
-		Node* next; // next in hash bucket
-		Node* prev; // prev in hash bucket
-		Node* list_next; // next in insertion order
-		Node* list_prev; // prev in insertion order
+template<class T>
+class pool_allocator {
+public:
+	typedef T value_type;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+	typedef std::false_type is_always_equal;
 
-		Node(const pair<const Key, T>& val) : data(val), next(nullptr), prev(nullptr), list_next(nullptr), list_prev(nullptr) {}
-		Node(pair<const Key, T>&& val) : data(std::move(val)), next(nullptr), prev(nullptr), list_next(nullptr), list_prev(nullptr) {}
+	template<class U>
+	struct rebind {
+		typedef pool_allocator<U> other;
 	};
 
-	// Hash table parameters
-	static const size_t INITIAL_CAPACITY = 16;
-	static const double LOAD_FACTOR;
+private:
+	template<class U> friend class pool_allocator;
 
-	Node** buckets;
-	size_t bucket_count;
-	size_t element_count;
+	typedef pool_allocator_detail::pool pool;
+	typedef pool_allocator_detail::slab slab;
 
-	// Doubly linked list for insertion order
-	Node* head;
-	Node* tail;
+	static const size_t FIRST_SLAB = 8;
+	static const size_t MAX_SLAB = 8192;
+	static const size_t ALIGNMENT = alignof(std::max_align_t);
+	static const size_t HEADER = (sizeof(slab) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	static const size_t POOL_HEADER = (sizeof(pool) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	// a multiple of T's alignment, so every block of a slab is aligned for T
+	static const size_t BLOCK_ALIGNMENT = alignof(T) > alignof(void *) ? alignof(T) : alignof(void *);
+	static const size_t BLOCK = ((sizeof(T) > sizeof(void *) ? sizeof(T) : sizeof(void *)) + BLOCK_ALIGNMENT - 1)
+		/ BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
 
-	Hash hasher;
-	Equal key_equal;
+	mutable pool *shared; // nullptr until the first allocation or copy
 
-	// Helper functions
-	size_t hash_index(const Key& key) const {
-		return hasher(key) % bucket_count;
+	// whether single Ts come from the pool; decided once per pool
+	bool pooled() const {
+		if (alignof(T) > ALIGNMENT) {
+			return false;
+		}
+		if (!shared) {
+			return true;
+		}
+		if (!shared->block) {
+			shared->block = BLOCK;
+		}
+		return shared->block == BLOCK;
 	}
 
-	void rehash(size_t new_capacity) {
-		Node** new_buckets = new Node*[new_capacity]();
+	void grow() {
+		size_t capacity = shared ? shared->next_capacity : FIRST_SLAB;
+		add_slab(capacity);
+		if (capacity < MAX_SLAB) {
+			shared->next_capacity = capacity * 2;
+		}
+	}
 
-		for (size_t i = 0; i < bucket_count; ++i) {
-			Node* current = buckets[i];
-			while (current) {
-				Node* next = current->next;
-				size_t new_index = hasher(current->data.first) % new_capacity;
+	// the first slab also holds the pool, so that a small map still
+	// costs a single allocation
+	void add_slab(size_t capacity) {
+		slab *s;
+		if (!shared) {
+			unsigned char *raw = static_cast<unsigned char *>(::operator new(POOL_HEADER + HEADER + capacity * BLOCK));
+			shared = ::new (static_cast<void *>(raw)) pool{1, BLOCK, FIRST_SLAB, nullptr, nullptr, nullptr, nullptr, true};
+			s = reinterpret_cast<slab *>(raw + POOL_HEADER);
+		} else {
+			s = static_cast<slab *>(::operator new(HEADER + capacity * BLOCK));
+		}
+		s->next = shared->slabs;
+		s->capacity = capacity;
+		shared->slabs = s;
+		shared->cursor = reinterpret_cast<unsigned char *>(s) + HEADER;
+		shared->limit = shared->cursor + capacity * BLOCK;
+	}
 
-				// Insert at head of new bucket
-				current->next = new_buckets[new_index];
-				if (new_buckets[new_index]) {
-					new_buckets[new_index]->prev = current;
-				}
-				current->prev = nullptr;
-				new_buckets[new_index] = current;
+	// the pool for a new copy; one that cannot be created leaves the
+	// copy with a pool of its own
+	pool *share() const noexcept {
+		if (!shared) {
+			void *raw;
+			try {
+				raw = ::operator new(sizeof(pool));
+			} catch (...) {
+				return nullptr;
+			}
+			shared = ::new (raw) pool{1, 0, FIRST_SLAB, nullptr, nullptr, nullptr, nullptr, false};
+		}
+		++shared->users;
+		return shared;
+	}
 
-				current = next;
+	void drop() noexcept {
+		if (!shared || --shared->users) {
+			return;
+		}
+		bool in_first_slab = shared->in_first_slab;
+		void *first = shared;
+		for (slab *s = shared->slabs; s;) {
+			slab *next = s->next;
+			if (!next && in_first_slab) {
+				::operator delete(first);
+			} else {
+				::operator delete(s);
 			}
+			s = next;
+		}
+		if (!in_first_slab) {
+			::operator delete(first);
 		}
+	}
 
-		delete[] buckets;
-		buckets = new_buckets;
-		bucket_count = new_capacity;
+public:
+	pool_allocator() noexcept : shared(nullptr) {}
+	pool_allocator(const pool_allocator &other) noexcept : shared(other.share()) {}
+	template<class U>
+	pool_allocator(const pool_allocator<U> &other) noexcept : shared(other.share()) {}
+	pool_allocator(pool_allocator &&other) noexcept : shared(other.shared) {
+		other.shared = nullptr;
 	}
 
-	void ensure_capacity() {
-		if (element_count >= bucket_count * LOAD_FACTOR) {
-			rehash(bucket_count * 2);
+	pool_allocator &operator=(const pool_allocator &other) noexcept {
+		if (this != &other && (!shared || shared != other.shared)) {
+			pool *p = other.share();
+			drop();
+			shared = p;
 		}
+		return *this;
+	}
+
+	pool_allocator &operator=(pool_allocator &&other) noexcept {
+		if (this != &other) {
+			drop();
+			shared = other.shared;
+			other.shared = nullptr;
+		}
+		return *this;
+	}
+
+	~pool_allocator() {
+		drop();
 	}
 
-public:
-	/**
-	 * the internal type of data.
-	 * it should have a default constructor, a copy constructor.
-	 * You can use sjtu::linked_hashmap as value_type by typedef.
-	 */
-	typedef pair<const Key, T> value_type;
- 
 	/**
-	 * see BidirectionalIterator at CppReference for help.
-	 *
-	 * if there is anything wrong throw invalid_iterator.
-	 *     like it = linked_hashmap.begin(); --it;
-	 *       or it = linked_hashmap.end(); ++end();
+	 * a copy with a pool of its own, for the copy of a container: copies
+	 * of a map share no memory, and each keeps its bulk release().
 	 */
-	friend class iterator;
-	friend class const_iterator;
+	pool_allocator select_on_container_copy_construction() const noexcept {
+		return pool_allocator();
+	}
 
-	class const_iterator;
-	class iterator {
-	public:
-		Node* current;
-		const linked_hashmap* container;
+	T *allocate(size_t n) {
+		if (n != 1 || !pooled()) {
+			return static_cast<T *>(::operator new(n * sizeof(T)));
+		}
+		void *b;
+		if (shared && shared->free_list) {
+			b = shared->free_list;
+			shared->free_list = *static_cast<void **>(b);
+		} else {
+			if (!shared || shared->cursor == shared->limit) {
+				grow();
+			}
+			b = shared->cursor;
+			shared->cursor += BLOCK;
+		}
+		return static_cast<T *>(b);
+	}
 
-		iterator(Node* node, const linked_hashmap* cont) : current(node), container(cont) {}
-		// The following code is written for the C++ type_traits library.
-		// Type traits is a C++ feature for describing certain properties of a type.
-		// For instance, for an iterator, iterator::value_type is the type that the
-		// iterator points to.
-		// STL algorithms and containers may use these type_traits (e.g. the following
-		// typedef) to work properly.
-		// See these websites for more information:
-		// https://en.cppreference.com/w/cpp/header/type_traits
-		// About value_type: https://blog.csdn.net/u014299153/article/details/72419713
-		// About iterator_category: https://en.cppreference.com/w/cpp/iterator
-		using difference_type = std::ptrdiff_t;
-		using value_type = typename linked_hashmap::value_type;
-		using pointer = value_type*;
-		using reference = value_type&;
-		using iterator_category = std::bidirectional_iterator_tag;
+	void deallocate(T *p, size_t n) noexcept {
+		if (n != 1 || !shared || !pooled()) {
+			::operator delete(p);
+			return;
+		}
+		*reinterpret_cast<void **>(p) = shared->free_list;
+		shared->free_list = p;
+	}
 
-		iterator() : current(nullptr), container(nullptr) {}
-		iterator(const iterator &other) : current(other.current), container(other.container) {}
+	/**
+	 * makes room for n more blocks in a single slab, so that a run of n
+	 * allocations on an empty free list is one contiguous batch. blocks
+	 * left over in the current slab go to the free list.
+	 */
+	void reserve(size_t n) {
+		if (!n || !pooled() || (shared && static_cast<size_t>(shared->limit - shared->cursor) >= n * BLOCK)) {
+			return;
+		}
+		while (shared && shared->cursor != shared->limit) {
+			void *b = shared->cursor;
+			shared->cursor += BLOCK;
+			*static_cast<void **>(b) = shared->free_list;
+			shared->free_list = b;
+		}
+		add_slab(n);
+	}
 
-		/**
-		 * TODO iter++
-		 */
-		iterator operator++(int) {
-			iterator temp = *this;
-			if (current) {
-				current = current->list_next;
-			}
-			return temp;
+	/**
+	 * n blocks in a row out of one slab, as an array T[n], or nullptr if
+	 * blocks of T are not laid out as one (padded, or not pooled). Each T
+	 * of the run is given back on its own with deallocate(p, 1), or with
+	 * the rest of the pool by release().
+	 */
+	T *allocate_run(size_t n) {
+		if (!n || BLOCK != sizeof(T) || !pooled()) {
+			return nullptr;
 		}
-		/**
-		 * TODO ++iter
-		 */
-		iterator & operator++() {
-			if (current) {
-				current = current->list_next;
+		reserve(n);
+		T *run = reinterpret_cast<T *>(shared->cursor);
+		shared->cursor += n * BLOCK;
+		return run;
+	}
+
+	/**
+	 * the bytes of all slabs of the pool, whether their blocks are in use
+	 * or not, and by whichever copy.
+	 */
+	size_t footprint() const noexcept {
+		size_t bytes = 0;
+		if (shared) {
+			for (const slab *s = shared->slabs; s; s = s->next) {
+				bytes += HEADER + s->capacity * shared->block;
 			}
-			return *this;
 		}
-		/**
-		 * TODO iter--
-		 */
-		iterator operator--(int) {
-			iterator temp = *this;
-			if (current) {
-				current = current->list_prev;
-			}
-			return temp;
+		return bytes;
+	}
+
+	/**
+	 * whether no other copy uses the pool, so that release() frees it.
+	 */
+	bool unshared() const noexcept {
+		return !shared || shared->users == 1;
+	}
+
+	/**
+	 * gives every slab back to the global allocator if unshared(), which
+	 * invalidates every block handed out; objects living in them must
+	 * have been destroyed already. A shared pool is left as it is to the
+	 * other copies. Either way this allocator starts afresh.
+	 */
+	void release() noexcept {
+		drop();
+		shared = nullptr;
+	}
+
+	void swap(pool_allocator &other) noexcept {
+		std::swap(shared, other.shared);
+	}
+
+	friend void swap(pool_allocator &lhs, pool_allocator &rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+	template<class U>
+	bool operator==(const pool_allocator<U> &rhs) const noexcept {
+		return shared ? shared == rhs.shared : static_cast<const void *>(this) == static_cast<const void *>(&rhs);
+	}
+
+	template<class U>
+	bool operator!=(const pool_allocator<U> &rhs) const noexcept {
+		return !(*this == rhs);
+	}
+};
+
+namespace shared_pool_detail {
+	struct slab {
+		slab *next;
+	};
+
+	// what every copy of a shared_pool_allocator points to
+	struct pool {
+		size_t users;
+		size_t block; // bytes per block, fixed by the first pooled allocation
+		size_t next_capacity;
+		slab *slabs;
+		void *free_list;
+		unsigned char *cursor; // bump pointer into the newest slab
+		unsigned char *limit;
+	};
+}
+
+    /**
+     * A pool allocator whose copies share one pool, for maps that hand
+     * nodes to each other: extract(), insert(node_type &&) and merge()
+     * relink nodes between maps with equal allocators instead of
+     * reallocating them.
+     *
+     * Copies, rebound ones included, draw from the same slabs and compare
+     * equal; the slabs are given back when the last copy goes. Blocks are
+     * sized for the first type allocated one at a time, and every other
+     * request goes to the global allocator. There is no release(), since
+     * other maps may still own blocks, so clear() returns nodes to the
+     * free list one by one. Unlike pool_allocator, copies of a container
+     * share the pool too. Not thread-safe: maps sharing a pool must not
+     * allocate from several threads at once.
+     */
+template<class T>
+class shared_pool_allocator {
+public:
+	typedef T value_type;
+	typedef std::size_t size_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef std::true_type propagate_on_container_copy_assignment;
+	typedef std::true_type propagate_on_container_move_assignment;
+	typedef std::true_type propagate_on_container_swap;
+	typedef std::false_type is_always_equal;
+
+	template<class U>
+	struct rebind {
+		typedef shared_pool_allocator<U> other;
+	};
+
+private:
+	template<class U> friend class shared_pool_allocator;
+
+	typedef shared_pool_detail::pool pool;
+	typedef shared_pool_detail::slab slab;
+
+	static const size_t FIRST_SLAB = 8;
+	static const size_t MAX_SLAB = 8192;
+	static const size_t ALIGNMENT = alignof(std::max_align_t);
+	static const size_t HEADER = (sizeof(slab) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+	// a multiple of T's alignment, so every block of a slab is aligned for T
+	static const size_t BLOCK_ALIGNMENT = alignof(T) > alignof(void *) ? alignof(T) : alignof(void *);
+	static const size_t BLOCK = ((sizeof(T) > sizeof(void *) ? sizeof(T) : sizeof(void *)) + BLOCK_ALIGNMENT - 1)
+		/ BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+
+	pool *shared;
+
+	// whether single Ts come from the pool; decided once per pool
+	bool pooled() const {
+		if (alignof(T) > ALIGNMENT) {
+			return false;
 		}
-		/**
-		 * TODO --iter
-		 */
-		iterator & operator--() {
-			if (current) {
-				current = current->list_prev;
-			}
-			return *this;
+		if (!shared->block) {
+			shared->block = BLOCK;
 		}
-		/**
-		 * a operator to check whether two iterators are same (pointing to the same memory).
-		 */
-		value_type & operator*() const {
-			return current->data;
+		return shared->block == BLOCK;
+	}
+
+	void grow() {
+		size_t capacity = shared->next_capacity;
+		slab *s = static_cast<slab *>(::operator new(HEADER + capacity * BLOCK));
+		s->next = shared->slabs;
+		shared->slabs = s;
+		shared->cursor = reinterpret_cast<unsigned char *>(s) + HEADER;
+		shared->limit = shared->cursor + capacity * BLOCK;
+		if (capacity < MAX_SLAB) {
+			shared->next_capacity = capacity * 2;
 		}
-		bool operator==(const iterator &rhs) const {
-			return current == rhs.current;
+	}
+
+	void drop() noexcept {
+		if (--shared->users) {
+			return;
 		}
-		bool operator==(const const_iterator &rhs) const {
-			return current == rhs.current;
+		while (shared->slabs) {
+			slab *next = shared->slabs->next;
+			::operator delete(shared->slabs);
+			shared->slabs = next;
 		}
-		/**
-		 * some other operator for iterator.
-		 */
-		bool operator!=(const iterator &rhs) const {
-			return current != rhs.current;
+		delete shared;
+	}
+
+public:
+	shared_pool_allocator() : shared(new pool{1, 0, FIRST_SLAB, nullptr, nullptr, nullptr, nullptr}) {}
+	shared_pool_allocator(const shared_pool_allocator &other) noexcept : shared(other.shared) {
+		++shared->users;
+	}
+	template<class U>
+	shared_pool_allocator(const shared_pool_allocator<U> &other) noexcept : shared(other.shared) {
+		++shared->users;
+	}
+
+	shared_pool_allocator &operator=(const shared_pool_allocator &other) noexcept {
+		if (shared != other.shared) {
+			++other.shared->users;
+			drop();
+			shared = other.shared;
 		}
-		bool operator!=(const const_iterator &rhs) const {
-			return current != rhs.current;
+		return *this;
+	}
+
+	~shared_pool_allocator() {
+		drop();
+	}
+
+	T *allocate(size_t n) {
+		if (n != 1 || !pooled()) {
+			return static_cast<T *>(::operator new(n * sizeof(T)));
 		}
+		void *b;
+		if (shared->free_list) {
+			b = shared->free_list;
+			shared->free_list = *static_cast<void **>(b);
+		} else {
+			if (shared->cursor == shared->limit) {
+				grow();
+			}
+			b = shared->cursor;
+			shared->cursor += BLOCK;
+		}
+		return static_cast<T *>(b);
+	}
 
-		/**
-		 * for the support of it->first.
-		 * See <http://kelvinh.github.io/blog/2013/11/20/overloading-of-member-access-operator-dash-greater-than-symbol-in-cpp/> for help.
-		 */
-		value_type* operator->() const noexcept {
-			return &(current->data);
+	void deallocate(T *p, size_t n) noexcept {
+		if (n != 1 || !pooled()) {
+			::operator delete(p);
+			return;
 		}
-	};
- 
-	class const_iterator {
-	public:
-		const Node* current;
-		const linked_hashmap* container;
+		*reinterpret_cast<void **>(p) = shared->free_list;
+		shared->free_list = p;
+	}
 
-		const_iterator(const Node* node, const linked_hashmap* cont) : current(node), container(cont) {}
-		using difference_type = std::ptrdiff_t;
-		using value_type = const typename linked_hashmap::value_type;
-		using pointer = value_type*;
-		using reference = value_type&;
-		using iterator_category = std::bidirectional_iterator_tag;
+	template<class U>
+	bool operator==(const shared_pool_allocator<U> &rhs) const noexcept {
+		return shared == rhs.shared;
+	}
+
+	template<class U>
+	bool operator!=(const shared_pool_allocator<U> &rhs) const noexcept {
+		return !(*this == rhs);
+	}
+};
+
+    /**
+     * true if Alloc can drop all of its memory at once through release(),
+     * which it does whenever unshared() holds.
+     */
+template<class Alloc, class = void>
+struct has_bulk_release : std::false_type {};
+
+template<class Alloc>
+struct has_bulk_release<Alloc, decltype(std::declval<Alloc &>().release(),
+	static_cast<bool>(std::declval<const Alloc &>().unshared()), void())> : std::true_type {};
+
+    /**
+     * true if Alloc can set aside room for n allocations through reserve(n).
+     */
+template<class Alloc, class = void>
+struct has_bulk_reserve : std::false_type {};
+
+template<class Alloc>
+struct has_bulk_reserve<Alloc, decltype(std::declval<Alloc &>().reserve(size_t()), void())> : std::true_type {};
+
+    /**
+     * true if Alloc can hand out n contiguous allocations at once through
+     * allocate_run(n).
+     */
+template<class Alloc, class = void>
+struct has_bulk_run : std::false_type {};
+
+template<class Alloc>
+struct has_bulk_run<Alloc, decltype(static_cast<typename Alloc::value_type *>(
+	std::declval<Alloc &>().allocate_run(size_t())), void())> : std::true_type {};
+
+    /**
+     * true if Alloc can tell the bytes it holds, in use or not, through
+     * footprint().
+     */
+template<class Alloc, class = void>
+struct has_footprint : std::false_type {};
+
+template<class Alloc>
+struct has_footprint<Alloc, decltype(static_cast<size_t>(std::declval<const Alloc &>().footprint()), void())> : std::true_type {};
+
+    /**
+     * Storage engines of linked_hashmap.
+     *
+     * An engine only decides how a node is found from its hash. Every
+     * engine keeps the insertion order in the list_next/list_prev chain
+     * of the nodes, so iteration order and iterator stability do not
+     * depend on the engine. An engine tag provides
+     *   node_base<Node>  the per-node links the engine needs;
+     *   index<Node>      the lookup structure, supporting
+     *                      find(hash, pred), insert(node, hash),
+     *                      erase(node, hash), rehash(count, hash_of),
+     *                      clear(), swap(other), bucket_count(),
+     *                      occupancy(size), the number of slots that
+     *                      count against the load factor, and
+     *                      load_limit(max_load), the occupancy at which
+     *                      the table has to grow, and migrate(hash_of),
+     *                      a bounded slice of deferred resizing work
+     *                      that linked_hashmap runs on every update,
+     *                      prefetch(hash), a cache hint for the slot a
+     *                      later find(hash, pred) starts at, and
+     *                      memory(), the bytes its arrays take.
+     * index<Node>::insert() never checks for duplicates and never grows;
+     * linked_hashmap does both before calling it.
+     *
+     * index(0) allocates nothing and reports bucket_count() 0. Such an
+     * index only ever sees clear(), swap() and rehash(), which gives it
+     * its first buckets; see linked_hashmap's small mode.
+     */
+
+    /**
+     * Bucket indexing policies: how an engine maps a hash to a bucket.
+     * A policy object lives in the engine's index and provides
+     *   static size_t round(size_t n)   the bucket count to use for >= n;
+     *   void resize(size_t count)       called with every count from round();
+     *   size_t operator()(size_t hash)  the bucket of hash.
+     */
+
+    /**
+     * power-of-two bucket counts indexed by Fibonacci (multiply-shift)
+     * hashing: one multiplication and a shift instead of a division.
+     * The multiplication spreads identity hashes such as std::hash<int>
+     * over the whole table, so sequential keys do not cluster.
+     */
+struct power_of_two_mix {
+	static unsigned long long mix(size_t hash) {
+		return static_cast<unsigned long long>(hash) * 0x9E3779B97F4A7C15ull;
+	}
 
-		const_iterator() : current(nullptr), container(nullptr) {}
-		const_iterator(const const_iterator &other) : current(other.current), container(other.container) {}
-		const_iterator(const iterator &other) : current(other.current), container(other.container) {}
+	static size_t round(size_t n) {
+		size_t count = 8;
+		while (count < n) {
+			count <<= 1;
+		}
+		return count;
+	}
+
+	void resize(size_t count) {
+		shift = 64;
+		while (count > 1) {
+			count >>= 1;
+			--shift;
+		}
+	}
+
+	size_t operator()(size_t hash) const {
+		return static_cast<size_t>(mix(hash) >> shift);
+	}
+
+private:
+	unsigned int shift = 61;
+};
+
+    /**
+     * prime bucket counts indexed by hash % bucket_count. Slower (an
+     * integer division per lookup) but robust against hashes whose low
+     * or high bits are poorly distributed.
+     */
+struct prime_modulo {
+	static size_t round(size_t n) {
+		// the smallest prime above each power of two from 8 to 2^63
+		static const unsigned long long primes[] = {
+			11ull, 17ull, 37ull, 67ull, 131ull, 257ull, 521ull, 1031ull, 2053ull, 4099ull, 8209ull,
+			16411ull, 32771ull, 65537ull, 131101ull, 262147ull, 524309ull, 1048583ull, 2097169ull,
+			4194319ull, 8388617ull, 16777259ull, 33554467ull, 67108879ull, 134217757ull, 268435459ull,
+			536870923ull, 1073741827ull, 2147483659ull, 4294967311ull, 8589934609ull, 17179869209ull,
+			34359738421ull, 68719476767ull, 137438953481ull, 274877906951ull, 549755813911ull,
+			1099511627791ull, 2199023255579ull, 4398046511119ull, 8796093022237ull, 17592186044423ull,
+			35184372088891ull, 70368744177679ull, 140737488355333ull, 281474976710677ull,
+			562949953421381ull, 1125899906842679ull, 2251799813685269ull, 4503599627370517ull,
+			9007199254740997ull, 18014398509482143ull, 36028797018963971ull, 72057594037928017ull,
+			144115188075855881ull, 288230376151711813ull, 576460752303423619ull,
+			1152921504606847009ull, 2305843009213693967ull, 4611686018427388039ull,
+			9223372036854775837ull
+		};
+		const size_t last = sizeof(primes) / sizeof(primes[0]) - 1;
+		size_t i = 0;
+		while (i < last && primes[i] < n) {
+			++i;
+		}
+		return static_cast<size_t>(primes[i]);
+	}
+
+	void resize(size_t n) {
+		count = n;
+	}
+
+	size_t operator()(size_t hash) const {
+		return hash % count;
+	}
+
+private:
+	size_t count = 1;
+};
+
+    /**
+     * separate chaining: one bucket per slot, colliding nodes are chained
+     * through Node::next/Node::prev.
+     */
+template<class Indexing = power_of_two_mix>
+struct chained_buckets {
+	template<class Node>
+	struct node_base {
+		Node* next = nullptr; // next in hash bucket
+		Node* prev = nullptr; // prev in hash bucket
+	};
+
+	template<class Node>
+	class index {
+	private:
+		Node** buckets;
+		size_t count;
+		Indexing bucket_of;
+
+	public:
+		explicit index(size_t n) : buckets(nullptr), count(n ? Indexing::round(n) : 0) {
+			if (count) {
+				buckets = new Node*[count]();
+				bucket_of.resize(count);
+			}
+		}
+		index(const index &) = delete;
+		index & operator=(const index &) = delete;
+
+		~index() {
+			delete[] buckets;
+		}
+
+		size_t bucket_count() const {
+			return count;
+		}
+
+		size_t memory() const {
+			return count * sizeof(Node*);
+		}
+
+		size_t occupancy(size_t size) const {
+			return size;
+		}
+
+		size_t load_limit(float max_load) const {
+			return static_cast<size_t>(count * max_load);
+		}
+
+		// nothing is ever deferred
+		template<class HashOf>
+		void migrate(HashOf) {}
+
+		template<class Pred>
+		Node* find(size_t hash, Pred pred) const {
+			Node* current = buckets[bucket_of(hash)];
+			while (current) {
+				SJTU_LINKED_HASHMAP_CHAIN_HINT(current->next);
+				if (pred(current)) {
+					return current;
+				}
+				current = current->next;
+			}
+			return nullptr;
+		}
+
+		void prefetch(size_t hash) const {
+			SJTU_LINKED_HASHMAP_PREFETCH(buckets + bucket_of(hash));
+		}
+
+		// the bucket of hash; find() and insert() of hashes in different
+		// buckets touch disjoint nodes, so threads may run them at once
+		size_t bucket(size_t hash) const {
+			return bucket_of(hash);
+		}
+
+		void insert(Node* node, size_t hash) {
+			size_t i = bucket_of(hash);
+			// Insert at head of bucket
+			node->next = buckets[i];
+			node->prev = nullptr;
+			if (buckets[i]) {
+				buckets[i]->prev = node;
+			}
+			buckets[i] = node;
+		}
+
+		void erase(Node* node, size_t hash) {
+			if (node->prev) {
+				node->prev->next = node->next;
+			} else {
+				buckets[bucket_of(hash)] = node->next;
+			}
+			if (node->next) {
+				node->next->prev = node->prev;
+			}
+		}
+
+		template<class HashOf>
+		void rehash(size_t n, HashOf hash_of) {
+			n = Indexing::round(n);
+			Node** new_buckets = new Node*[n]();
+			Indexing new_bucket_of;
+			new_bucket_of.resize(n);
+
+			for (size_t i = 0; i < count; ++i) {
+				Node* current = buckets[i];
+				while (current) {
+					Node* next = current->next;
+					size_t new_index = new_bucket_of(hash_of(current));
+
+					// Insert at head of new bucket
+					current->next = new_buckets[new_index];
+					if (new_buckets[new_index]) {
+						new_buckets[new_index]->prev = current;
+					}
+					current->prev = nullptr;
+					new_buckets[new_index] = current;
+
+					current = next;
+				}
+			}
+
+			delete[] buckets;
+			buckets = new_buckets;
+			count = n;
+			bucket_of = new_bucket_of;
+		}
+
+		void clear() {
+			for (size_t i = 0; i < count; ++i) {
+				buckets[i] = nullptr;
+			}
+		}
+
+		void swap(index &other) {
+			std::swap(buckets, other.buckets);
+			std::swap(count, other.count);
+			std::swap(bucket_of, other.bucket_of);
+		}
+	};
+};
+
+    /**
+     * separate chaining with incremental (Redis style) resizing.
+     *
+     * Growing allocates the new bucket array but keeps the old one; every
+     * insert and erase then migrates a bounded number of old buckets, so
+     * no single operation pays for moving the whole table. Old buckets
+     * below the migration cursor are already moved, so a hash is looked up
+     * in exactly one of the two arrays, and inserts into a bucket that has
+     * not been moved yet go to the old array and move with it later.
+     * An explicit rehash() first finishes a running migration.
+     */
+template<class Indexing = power_of_two_mix>
+struct incremental_chained {
+	template<class Node>
+	using node_base = typename chained_buckets<Indexing>::template node_base<Node>;
+
+	template<class Node>
+	class index {
+	private:
+		static const size_t STEP = 4; // old buckets moved per operation
+		static const size_t EMPTY_VISITS = 40; // empty old buckets skipped per operation
+
+		Node** buckets;
+		size_t count;
+		Indexing bucket_of;
+
+		// the array being drained, nullptr when no migration is running
+		Node** old_buckets;
+		size_t old_count;
+		Indexing old_bucket_of;
+		size_t cursor;
+
+		Node** slot_of(size_t hash) const {
+			if (old_buckets) {
+				size_t i = old_bucket_of(hash);
+				if (i >= cursor) {
+					return old_buckets + i;
+				}
+			}
+			return buckets + bucket_of(hash);
+		}
+
+		template<class HashOf>
+		void move_bucket(size_t i, HashOf &hash_of) {
+			Node* current = old_buckets[i];
+			while (current) {
+				Node* next = current->next;
+				size_t new_index = bucket_of(hash_of(current));
+				current->next = buckets[new_index];
+				if (buckets[new_index]) {
+					buckets[new_index]->prev = current;
+				}
+				current->prev = nullptr;
+				buckets[new_index] = current;
+				current = next;
+			}
+			old_buckets[i] = nullptr;
+		}
+
+		// calloc leaves large arrays to lazily zeroed pages, so starting a
+		// migration does not touch the whole new array at once
+		static Node** allocate(size_t n) {
+			void* p = std::calloc(n, sizeof(Node*));
+			if (!p) {
+				throw std::bad_alloc();
+			}
+			return static_cast<Node**>(p);
+		}
+
+		void end_migration() {
+			std::free(old_buckets);
+			old_buckets = nullptr;
+			old_count = cursor = 0;
+		}
+
+		template<class HashOf>
+		void finish(HashOf &hash_of) {
+			if (!old_buckets) {
+				return;
+			}
+			for (; cursor < old_count; ++cursor) {
+				move_bucket(cursor, hash_of);
+			}
+			end_migration();
+		}
+
+	public:
+		explicit index(size_t n) : buckets(nullptr), count(n ? Indexing::round(n) : 0), old_buckets(nullptr), old_count(0), cursor(0) {
+			if (count) {
+				buckets = allocate(count);
+				bucket_of.resize(count);
+			}
+		}
+		index(const index &) = delete;
+		index & operator=(const index &) = delete;
+
+		~index() {
+			std::free(buckets);
+			std::free(old_buckets);
+		}
+
+		size_t bucket_count() const {
+			return count;
+		}
+
+		size_t memory() const {
+			return (count + old_count) * sizeof(Node*);
+		}
+
+		size_t occupancy(size_t size) const {
+			return size;
+		}
+
+		size_t load_limit(float max_load) const {
+			return static_cast<size_t>(count * max_load);
+		}
+
+		bool migrating() const {
+			return old_buckets != nullptr;
+		}
+
+		template<class Pred>
+		Node* find(size_t hash, Pred pred) const {
+			Node* current = *slot_of(hash);
+			while (current) {
+				SJTU_LINKED_HASHMAP_CHAIN_HINT(current->next);
+				if (pred(current)) {
+					return current;
+				}
+				current = current->next;
+			}
+			return nullptr;
+		}
+
+		void prefetch(size_t hash) const {
+			SJTU_LINKED_HASHMAP_PREFETCH(slot_of(hash));
+		}
+
+		void insert(Node* node, size_t hash) {
+			Node** slot = slot_of(hash);
+			node->next = *slot;
+			node->prev = nullptr;
+			if (*slot) {
+				(*slot)->prev = node;
+			}
+			*slot = node;
+		}
+
+		void erase(Node* node, size_t hash) {
+			if (node->prev) {
+				node->prev->next = node->next;
+			} else {
+				*slot_of(hash) = node->next;
+			}
+			if (node->next) {
+				node->next->prev = node->prev;
+			}
+		}
+
+		// moves up to STEP non-empty old buckets into the new array
+		template<class HashOf>
+		void migrate(HashOf hash_of) {
+			if (!old_buckets) {
+				return;
+			}
+			for (size_t moved = 0, visited = 0; cursor < old_count && moved < STEP && visited < EMPTY_VISITS; ++cursor, ++visited) {
+				if (old_buckets[cursor]) {
+					move_bucket(cursor, hash_of);
+					++moved;
+				}
+			}
+			if (cursor == old_count) {
+				end_migration();
+			}
+		}
+
+		template<class HashOf>
+		void rehash(size_t n, HashOf hash_of) {
+			finish(hash_of);
+			if (!buckets) {
+				// nothing to migrate from
+				buckets = allocate(Indexing::round(n));
+				count = Indexing::round(n);
+				bucket_of.resize(count);
+				return;
+			}
+			old_buckets = buckets;
+			old_count = count;
+			old_bucket_of = bucket_of;
+			cursor = 0;
+			count = Indexing::round(n);
+			try {
+				buckets = allocate(count);
+			} catch (...) {
+				buckets = old_buckets;
+				count = old_count;
+				old_buckets = nullptr;
+				old_count = 0;
+				throw;
+			}
+			bucket_of.resize(count);
+		}
+
+		void clear() {
+			if (old_buckets) {
+				end_migration();
+			}
+			for (size_t i = 0; i < count; ++i) {
+				buckets[i] = nullptr;
+			}
+		}
+
+		void swap(index &other) {
+			std::swap(buckets, other.buckets);
+			std::swap(count, other.count);
+			std::swap(bucket_of, other.bucket_of);
+			std::swap(old_buckets, other.old_buckets);
+			std::swap(old_count, other.old_count);
+			std::swap(old_bucket_of, other.old_bucket_of);
+			std::swap(cursor, other.cursor);
+		}
+	};
+};
+
+    /**
+     * separate chaining whose over-long chains turn into balanced trees,
+     * as in Java 8's HashMap: a bucket that grows past TREEIFY nodes
+     * becomes an AVL tree ordered by the full hash, and turns back into
+     * a chain when it shrinks below UNTREEIFY. However the keys collide
+     * in their bucket, a lookup costs O(log n) hash comparisons and calls
+     * Equal only on the keys whose full hash matches.
+     *
+     * Keys with equal full hashes still sit side by side in the tree and
+     * are searched one by one; only a hash the attacker cannot predict,
+     * such as seeded_hash, protects against those.
+     */
+template<class Indexing = power_of_two_mix>
+struct treeified_buckets {
+	static const size_t TREEIFY = 8;
+	static const size_t UNTREEIFY = 6;
+
+	template<class Node>
+	struct node_base {
+		// in a tree bucket, next and prev are the left and right child
+		Node* next = nullptr;
+		Node* prev = nullptr;
+		Node* parent = nullptr; // tree buckets only
+		size_t tree_hash = 0;
+		int height = 0;
+	};
+
+	template<class Node>
+	class index {
+	private:
+		struct bucket {
+			Node* head; // the chain, or the root of the tree
+			size_t length;
+			bool tree;
+		};
+
+		bucket* buckets;
+		size_t count;
+		Indexing bucket_of;
+
+		static Node*& left(Node* node) {
+			return node->next;
+		}
+
+		static Node*& right(Node* node) {
+			return node->prev;
+		}
+
+		static int height(const Node* node) {
+			return node ? node->height : 0;
+		}
+
+		static void update(Node* node) {
+			int l = height(left(node)), r = height(right(node));
+			node->height = (l > r ? l : r) + 1;
+		}
+
+		// puts child where old was below parent (or at the root)
+		static void replace(Node*& root, Node* parent, Node* old, Node* child) {
+			if (!parent) {
+				root = child;
+			} else if (left(parent) == old) {
+				left(parent) = child;
+			} else {
+				right(parent) = child;
+			}
+			if (child) {
+				child->parent = parent;
+			}
+		}
+
+		static Node* rotate_left(Node*& root, Node* x) {
+			Node* y = right(x);
+			right(x) = left(y);
+			if (left(y)) {
+				left(y)->parent = x;
+			}
+			replace(root, x->parent, x, y);
+			left(y) = x;
+			x->parent = y;
+			update(x);
+			update(y);
+			return y;
+		}
+
+		static Node* rotate_right(Node*& root, Node* x) {
+			Node* y = left(x);
+			left(x) = right(y);
+			if (right(y)) {
+				right(y)->parent = x;
+			}
+			replace(root, x->parent, x, y);
+			right(y) = x;
+			x->parent = y;
+			update(x);
+			update(y);
+			return y;
+		}
+
+		// restores the heights and the AVL balance from node up to the root
+		static void rebalance(Node*& root, Node* node) {
+			while (node) {
+				update(node);
+				int balance = height(left(node)) - height(right(node));
+				if (balance > 1) {
+					if (height(left(left(node))) < height(right(left(node)))) {
+						rotate_left(root, left(node));
+					}
+					node = rotate_right(root, node);
+				} else if (balance < -1) {
+					if (height(right(right(node))) < height(left(right(node)))) {
+						rotate_right(root, right(node));
+					}
+					node = rotate_left(root, node);
+				}
+				node = node->parent;
+			}
+		}
+
+		// equal hashes go right, so they stay in insertion order in the tree
+		static void tree_insert(Node*& root, Node* node) {
+			left(node) = right(node) = nullptr;
+			node->height = 1;
+			if (!root) {
+				root = node;
+				node->parent = nullptr;
+				return;
+			}
+			Node* current = root;
+			for (;;) {
+				Node*& child = node->tree_hash < current->tree_hash ? left(current) : right(current);
+				if (!child) {
+					child = node;
+					break;
+				}
+				current = child;
+			}
+			node->parent = current;
+			rebalance(root, current);
+		}
+
+		static void tree_erase(Node*& root, Node* node) {
+			Node* from;
+			if (!left(node) || !right(node)) {
+				from = node->parent;
+				replace(root, node->parent, node, left(node) ? left(node) : right(node));
+			} else {
+				// the successor takes node's place
+				Node* successor = right(node);
+				while (left(successor)) {
+					successor = left(successor);
+				}
+				if (successor->parent == node) {
+					from = successor;
+				} else {
+					from = successor->parent;
+					replace(root, successor->parent, successor, right(successor));
+					right(successor) = right(node);
+					right(successor)->parent = successor;
+				}
+				left(successor) = left(node);
+				left(successor)->parent = successor;
+				replace(root, node->parent, node, successor);
+			}
+			rebalance(root, from);
+		}
+
+		static Node* successor(Node* node) {
+			if (right(node)) {
+				node = right(node);
+				while (left(node)) {
+					node = left(node);
+				}
+				return node;
+			}
+			Node* parent = node->parent;
+			while (parent && node == right(parent)) {
+				node = parent;
+				parent = parent->parent;
+			}
+			return parent;
+		}
+
+		// calls fn on every node of b; fn may relink the node it is given
+		template<class Fn>
+		static void drain(const bucket &b, Fn fn) {
+			if (!b.tree) {
+				for (Node* current = b.head; current;) {
+					Node* next = current->next;
+					fn(current);
+					current = next;
+				}
+				return;
+			}
+			// an AVL tree of 2^64 nodes is less than 93 levels high
+			Node* pending[128];
+			size_t top = 0;
+			if (b.head) {
+				pending[top++] = b.head;
+			}
+			while (top) {
+				Node* current = pending[--top];
+				if (left(current)) {
+					pending[top++] = left(current);
+				}
+				if (right(current)) {
+					pending[top++] = right(current);
+				}
+				fn(current);
+			}
+		}
+
+		static void push_front(bucket &b, Node* node) {
+			node->next = b.head;
+			node->prev = nullptr;
+			if (b.head) {
+				b.head->prev = node;
+			}
+			b.head = node;
+		}
+
+		static void treeify(bucket &b) {
+			Node* root = nullptr;
+			drain(b, [&root](Node* node) { tree_insert(root, node); });
+			b.head = root;
+			b.tree = true;
+		}
+
+		static void untreeify(bucket &b) {
+			bucket chain = {nullptr, b.length, false};
+			drain(b, [&chain](Node* node) { push_front(chain, node); });
+			b = chain;
+		}
+
+	public:
+		explicit index(size_t n) : buckets(nullptr), count(n ? Indexing::round(n) : 0) {
+			if (count) {
+				buckets = new bucket[count]();
+				bucket_of.resize(count);
+			}
+		}
+		index(const index &) = delete;
+		index & operator=(const index &) = delete;
+
+		~index() {
+			delete[] buckets;
+		}
+
+		size_t bucket_count() const {
+			return count;
+		}
+
+		size_t memory() const {
+			return count * sizeof(bucket);
+		}
+
+		size_t occupancy(size_t size) const {
+			return size;
+		}
+
+		size_t load_limit(float max_load) const {
+			return static_cast<size_t>(count * max_load);
+		}
+
+		// nothing is ever deferred
+		template<class HashOf>
+		void migrate(HashOf) {}
+
+		template<class Pred>
+		Node* find(size_t hash, Pred pred) const {
+			const bucket &b = buckets[bucket_of(hash)];
+			if (!b.tree) {
+				for (Node* current = b.head; current; current = current->next) {
+					SJTU_LINKED_HASHMAP_CHAIN_HINT(current->next);
+					if (pred(current)) {
+						return current;
+					}
+				}
+				return nullptr;
+			}
+			// the first node of hash, then the ones that follow it in order
+			Node* first = nullptr;
+			for (Node* current = b.head; current;) {
+				if (current->tree_hash < hash) {
+					current = right(current);
+				} else {
+					first = current;
+					current = left(current);
+				}
+			}
+			for (Node* current = first; current && current->tree_hash == hash; current = successor(current)) {
+				if (pred(current)) {
+					return current;
+				}
+			}
+			return nullptr;
+		}
+
+		void prefetch(size_t hash) const {
+			SJTU_LINKED_HASHMAP_PREFETCH(buckets + bucket_of(hash));
+		}
+
+		void insert(Node* node, size_t hash) {
+			bucket &b = buckets[bucket_of(hash)];
+			node->tree_hash = hash;
+			++b.length;
+			if (b.tree) {
+				tree_insert(b.head, node);
+				return;
+			}
+			push_front(b, node);
+			if (b.length > TREEIFY) {
+				treeify(b);
+			}
+		}
+
+		void erase(Node* node, size_t hash) {
+			bucket &b = buckets[bucket_of(hash)];
+			--b.length;
+			if (b.tree) {
+				tree_erase(b.head, node);
+				if (b.length < UNTREEIFY) {
+					untreeify(b);
+				}
+				return;
+			}
+			if (node->prev) {
+				node->prev->next = node->next;
+			} else {
+				b.head = node->next;
+			}
+			if (node->next) {
+				node->next->prev = node->prev;
+			}
+		}
+
+		// the hashes are kept in the nodes, so hash_of is never called
+		template<class HashOf>
+		void rehash(size_t n, HashOf) {
+			n = Indexing::round(n);
+			bucket* new_buckets = new bucket[n]();
+			Indexing new_bucket_of;
+			new_bucket_of.resize(n);
+
+			for (size_t i = 0; i < count; ++i) {
+				drain(buckets[i], [&](Node* node) {
+					bucket &target = new_buckets[new_bucket_of(node->tree_hash)];
+					push_front(target, node);
+					++target.length;
+				});
+			}
+			for (size_t i = 0; i < n; ++i) {
+				if (new_buckets[i].length > TREEIFY) {
+					treeify(new_buckets[i]);
+				}
+			}
+
+			delete[] buckets;
+			buckets = new_buckets;
+			count = n;
+			bucket_of = new_bucket_of;
+		}
+
+		void clear() {
+			for (size_t i = 0; i < count; ++i) {
+				buckets[i] = bucket();
+			}
+		}
+
+		void swap(index &other) {
+			std::swap(buckets, other.buckets);
+			std::swap(count, other.count);
+			std::swap(bucket_of, other.bucket_of);
+		}
+	};
+};
+
+    /**
+     * open addressing with Robin Hood linear probing.
+     *
+     * The table is one flat array of slots, each holding the node, 32 bits
+     * of its mixed hash as a fingerprint and its distance from the home
+     * slot. Probing compares fingerprints first, so the Equal functor is
+     * practically only called on the matching key, and a probe stops as
+     * soon as it meets a slot that is closer to its home than we are.
+     * Erase uses backward shifting, so there are no tombstones. rehash()
+     * grows past the count it is given when the entries would not leave
+     * a slot empty, and leaves the table as it was if it cannot allocate.
+     */
+template<class Indexing = power_of_two_mix>
+struct open_addressing {
+	template<class Node>
+	struct node_base {};
+
+	template<class Node>
+	class index {
+	private:
+		struct slot {
+			Node* node;
+			unsigned int fingerprint;
+			unsigned int distance;
+		};
+
+		slot* slots;
+		size_t count;
+		Indexing bucket_of;
+
+		static unsigned int fingerprint_of(size_t hash) {
+			return static_cast<unsigned int>(power_of_two_mix::mix(hash));
+		}
+
+		size_t next(size_t i) const {
+			return i + 1 == count ? 0 : i + 1;
+		}
+
+		void place(Node* node, size_t hash) {
+			slot entry = {node, fingerprint_of(hash), 0};
+			for (size_t i = bucket_of(hash);; i = next(i)) {
+				if (!slots[i].node) {
+					slots[i] = entry;
+					return;
+				}
+				if (slots[i].distance < entry.distance) {
+					std::swap(slots[i], entry);
+				}
+				++entry.distance;
+			}
+		}
+
+		// the most entries a table of count slots may hold
+		static size_t ceiling(size_t count) {
+			return count - count / 16 - 1;
+		}
+
+		// an empty table of at least n slots with room for live entries;
+		// nothing changes if the allocation throws
+		void allocate(size_t n, size_t live) {
+			size_t new_count = Indexing::round(n);
+			while (ceiling(new_count) < live) {
+				new_count = Indexing::round(new_count * 2);
+			}
+			slot* new_slots = new slot[new_count]();
+			Indexing new_bucket_of;
+			new_bucket_of.resize(new_count);
+			slots = new_slots;
+			count = new_count;
+			bucket_of = new_bucket_of;
+		}
+
+	public:
+		explicit index(size_t n) : slots(nullptr), count(0) {
+			if (n) {
+				allocate(n, 0);
+			}
+		}
+		index(const index &) = delete;
+		index & operator=(const index &) = delete;
+
+		~index() {
+			delete[] slots;
+		}
+
+		size_t bucket_count() const {
+			return count;
+		}
+
+		size_t memory() const {
+			return count * sizeof(slot);
+		}
+
+		size_t occupancy(size_t size) const {
+			return size;
+		}
+
+		// probe sequences must always end at an empty slot
+		size_t load_limit(float max_load) const {
+			size_t limit = static_cast<size_t>(count * max_load);
+			size_t most = count ? ceiling(count) : 0;
+			return limit < most ? limit : most;
+		}
+
+		// nothing is ever deferred
+		template<class HashOf>
+		void migrate(HashOf) {}
+
+		template<class Pred>
+		Node* find(size_t hash, Pred pred) const {
+			unsigned int fingerprint = fingerprint_of(hash);
+			for (size_t i = bucket_of(hash), d = 0;; i = next(i), ++d) {
+				const slot &s = slots[i];
+				if (!s.node || s.distance < d) {
+					return nullptr;
+				}
+				if (s.fingerprint == fingerprint && pred(s.node)) {
+					return s.node;
+				}
+			}
+		}
+
+		void prefetch(size_t hash) const {
+			SJTU_LINKED_HASHMAP_PREFETCH(slots + bucket_of(hash));
+		}
+
+		void insert(Node* node, size_t hash) {
+			place(node, hash);
+		}
+
+		void erase(Node* node, size_t hash) {
+			size_t i = bucket_of(hash);
+			while (slots[i].node != node) {
+				i = next(i);
+			}
+			// backward shift: pull the following displaced slots one step closer
+			for (size_t j = next(i); slots[j].node && slots[j].distance > 0; j = next(j)) {
+				slots[i] = slots[j];
+				--slots[i].distance;
+				i = j;
+			}
+			slots[i].node = nullptr;
+			slots[i].distance = 0;
+		}
+
+		template<class HashOf>
+		void rehash(size_t n, HashOf hash_of) {
+			slot* old_slots = slots;
+			size_t old_count = count;
+			size_t live = 0;
+			for (size_t i = 0; i < old_count; ++i) {
+				live += old_slots[i].node != nullptr;
+			}
+			allocate(n, live);
+			for (size_t i = 0; i < old_count; ++i) {
+				if (old_slots[i].node) {
+					place(old_slots[i].node, hash_of(old_slots[i].node));
+				}
+			}
+			delete[] old_slots;
+		}
+
+		void clear() {
+			for (size_t i = 0; i < count; ++i) {
+				slots[i].node = nullptr;
+				slots[i].distance = 0;
+			}
+		}
+
+		void swap(index &other) {
+			std::swap(slots, other.slots);
+			std::swap(count, other.count);
+			std::swap(bucket_of, other.bucket_of);
+		}
+	};
+};
+
+    /**
+     * Swiss-table style open addressing with SIMD group probing.
+     *
+     * Next to the node array lives one control byte per slot: the top
+     * 7 bits of the mixed hash for a full slot, or EMPTY/DELETED. A probe
+     * loads a whole group of control bytes and finds every slot of the
+     * group with a matching fingerprint in one compare-and-movemask, so
+     * Equal is almost never called on a non-matching key. Groups are 32
+     * wide with AVX2, 16 wide with SSE2 and 16 wide through a plain loop
+     * otherwise (or when SJTU_LINKED_HASHMAP_NO_SIMD is defined).
+     * Groups are probed triangularly; erase leaves a DELETED tombstone
+     * unless the group still has an empty slot. rehash() keeps an eighth
+     * of the slots EMPTY whatever count it is given, and a find() that
+     * meets none still stops after visiting every group once.
+     */
+struct swiss_groups {
+	template<class Node>
+	struct node_base {};
+
+	template<class Node>
+	class index {
+	private:
+		static const signed char EMPTY = -128;
+		static const signed char DELETED = -2;
+
+#if defined(__AVX2__) && !defined(SJTU_LINKED_HASHMAP_NO_SIMD)
+		static const size_t GROUP = 32;
+
+		struct group {
+			__m256i ctrl;
+			explicit group(const signed char* p) : ctrl(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p))) {}
+			unsigned int match(signed char h2) const {
+				return static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8(h2))));
+			}
+			unsigned int match_empty() const {
+				return match(EMPTY);
+			}
+			// EMPTY and DELETED are the only control bytes with the sign bit set
+			unsigned int match_free() const {
+				return static_cast<unsigned int>(_mm256_movemask_epi8(ctrl));
+			}
+		};
+#elif defined(__SSE2__) && !defined(SJTU_LINKED_HASHMAP_NO_SIMD)
+		static const size_t GROUP = 16;
+
+		struct group {
+			__m128i ctrl;
+			explicit group(const signed char* p) : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) {}
+			unsigned int match(signed char h2) const {
+				return static_cast<unsigned int>(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(h2))));
+			}
+			unsigned int match_empty() const {
+				return match(EMPTY);
+			}
+			unsigned int match_free() const {
+				return static_cast<unsigned int>(_mm_movemask_epi8(ctrl));
+			}
+		};
+#else
+		static const size_t GROUP = 16;
+
+		struct group {
+			const signed char* ctrl;
+			explicit group(const signed char* p) : ctrl(p) {}
+			unsigned int match(signed char h2) const {
+				unsigned int mask = 0;
+				for (size_t i = 0; i < GROUP; ++i) {
+					mask |= static_cast<unsigned int>(ctrl[i] == h2) << i;
+				}
+				return mask;
+			}
+			unsigned int match_empty() const {
+				return match(EMPTY);
+			}
+			unsigned int match_free() const {
+				unsigned int mask = 0;
+				for (size_t i = 0; i < GROUP; ++i) {
+					mask |= static_cast<unsigned int>(ctrl[i] < 0) << i;
+				}
+				return mask;
+			}
+		};
+#endif
+
+		signed char* ctrl;
+		Node** nodes;
+		size_t count;
+		size_t group_mask;
+		unsigned int group_shift;
+		size_t tombstones;
+
+		static unsigned int lowest_bit(unsigned int mask) {
+#if defined(__GNUC__)
+			return static_cast<unsigned int>(__builtin_ctz(mask));
+#else
+			unsigned int r = 0;
+			while (!(mask & 1u)) {
+				mask >>= 1;
+				++r;
+			}
+			return r;
+#endif
+		}
+
+		static unsigned long long mix(size_t hash) {
+			return power_of_two_mix::mix(hash);
+		}
+
+		// the top 7 bits are the fingerprint, the bits right below pick the first group
+		static signed char h2(unsigned long long mixed) {
+			return static_cast<signed char>(mixed >> 57);
+		}
+
+		size_t first_group(unsigned long long mixed) const {
+			return static_cast<size_t>(mixed >> group_shift) & group_mask;
+		}
+
+		// finds a free slot for mixed and fills it
+		void place(Node* node, unsigned long long mixed) {
+			for (size_t g = first_group(mixed), step = 0;; g = (g + ++step) & group_mask) {
+				unsigned int free = group(ctrl + g * GROUP).match_free();
+				if (free) {
+					size_t i = g * GROUP + lowest_bit(free);
+					if (ctrl[i] == DELETED) {
+						--tombstones;
+					}
+					ctrl[i] = h2(mixed);
+					nodes[i] = node;
+					return;
+				}
+			}
+		}
+
+		// an empty table of at least n slots, in which live entries leave
+		// an eighth of the slots EMPTY, so that every probe has somewhere
+		// to stop. Nothing changes if an allocation throws.
+		void allocate(size_t n, size_t live) {
+			size_t slots = GROUP;
+			while (slots < n || slots - slots / 8 < live) {
+				slots <<= 1;
+			}
+			signed char* new_ctrl = new signed char[slots];
+			Node** new_nodes;
+			try {
+				new_nodes = new Node*[slots];
+			} catch (...) {
+				delete[] new_ctrl;
+				throw;
+			}
+			std::memset(new_ctrl, EMPTY, slots);
+			ctrl = new_ctrl;
+			nodes = new_nodes;
+			count = slots;
+			size_t groups = count / GROUP;
+			group_mask = groups - 1;
+			group_shift = 57;
+			while (groups > 1) {
+				groups >>= 1;
+				--group_shift;
+			}
+			tombstones = 0;
+		}
+
+	public:
+		explicit index(size_t n) : ctrl(nullptr), nodes(nullptr), count(0), group_mask(0), group_shift(57), tombstones(0) {
+			if (n) {
+				allocate(n, 0);
+			}
+		}
+		index(const index &) = delete;
+		index & operator=(const index &) = delete;
+
+		~index() {
+			delete[] ctrl;
+			delete[] nodes;
+		}
+
+		size_t bucket_count() const {
+			return count;
+		}
+
+		size_t memory() const {
+			return count * (sizeof(signed char) + sizeof(Node*));
+		}
+
+		// tombstones take up room just like live entries until the next rehash
+		size_t occupancy(size_t size) const {
+			return size + tombstones;
+		}
+
+		// group probing degrades quickly beyond 7/8 full
+		size_t load_limit(float max_load) const {
+			size_t limit = static_cast<size_t>(count * max_load);
+			size_t ceiling = count - count / 8;
+			return limit < ceiling ? limit : ceiling;
+		}
+
+		// nothing is ever deferred
+		template<class HashOf>
+		void migrate(HashOf) {}
+
+		template<class Pred>
+		Node* find(size_t hash, Pred pred) const {
+			unsigned long long mixed = mix(hash);
+			signed char fingerprint = h2(mixed);
+			// triangular steps visit every group once in group_mask + 1 steps
+			for (size_t g = first_group(mixed), step = 0; step <= group_mask; g = (g + ++step) & group_mask) {
+				group grp(ctrl + g * GROUP);
+				for (unsigned int m = grp.match(fingerprint); m; m &= m - 1) {
+					Node* node = nodes[g * GROUP + lowest_bit(m)];
+					if (pred(node)) {
+						return node;
+					}
+				}
+				if (grp.match_empty()) {
+					return nullptr;
+				}
+			}
+			return nullptr;
+		}
+
+		void prefetch(size_t hash) const {
+			size_t g = first_group(mix(hash));
+			SJTU_LINKED_HASHMAP_PREFETCH(ctrl + g * GROUP);
+			SJTU_LINKED_HASHMAP_PREFETCH(nodes + g * GROUP);
+		}
+
+		void insert(Node* node, size_t hash) {
+			place(node, mix(hash));
+		}
+
+		void erase(Node* node, size_t hash) {
+			unsigned long long mixed = mix(hash);
+			signed char fingerprint = h2(mixed);
+			for (size_t g = first_group(mixed), step = 0;; g = (g + ++step) & group_mask) {
+				group grp(ctrl + g * GROUP);
+				for (unsigned int m = grp.match(fingerprint); m; m &= m - 1) {
+					size_t i = g * GROUP + lowest_bit(m);
+					if (nodes[i] == node) {
+						// no probe ever went past a group that still has an empty slot
+						if (grp.match_empty()) {
+							ctrl[i] = EMPTY;
+						} else {
+							ctrl[i] = DELETED;
+							++tombstones;
+						}
+						return;
+					}
+				}
+			}
+		}
+
+		template<class HashOf>
+		void rehash(size_t n, HashOf hash_of) {
+			signed char* old_ctrl = ctrl;
+			Node** old_nodes = nodes;
+			size_t old_count = count;
+			size_t live = 0;
+			for (size_t i = 0; i < old_count; ++i) {
+				live += old_ctrl[i] >= 0;
+			}
+			allocate(n, live);
+			for (size_t i = 0; i < old_count; ++i) {
+				if (old_ctrl[i] >= 0) {
+					place(old_nodes[i], mix(hash_of(old_nodes[i])));
+				}
+			}
+			delete[] old_ctrl;
+			delete[] old_nodes;
+		}
+
+		void clear() {
+			if (count) {
+				std::memset(ctrl, EMPTY, count);
+			}
+			tombstones = 0;
+		}
+
+		void swap(index &other) {
+			std::swap(ctrl, other.ctrl);
+			std::swap(nodes, other.nodes);
+			std::swap(count, other.count);
+			std::swap(group_mask, other.group_mask);
+			std::swap(group_shift, other.group_shift);
+			std::swap(tombstones, other.tombstones);
+		}
+	};
+};
+
+    /**
+     * the engine used when linked_hashmap is instantiated without one;
+     * the test build overrides it to run every suite against each engine.
+     */
+#ifndef SJTU_LINKED_HASHMAP_DEFAULT_ENGINE
+#define SJTU_LINKED_HASHMAP_DEFAULT_ENGINE sjtu::chained_buckets<>
+#endif
+
+    /**
+     * a fast hash for integral and enum keys: the 64-bit finalizer of
+     * MurmurHash3, two multiplications and three shifts. Unlike the
+     * identity std::hash of most libraries it spreads every bit of the
+     * key over the whole hash, which prime_modulo and the other
+     * containers of this library index by directly; being a bijection,
+     * distinct keys never share a full hash.
+     */
+struct integral_hash {
+	template<class I, class = typename std::enable_if<std::is_integral<I>::value || std::is_enum<I>::value>::type>
+	size_t operator()(I key) const noexcept {
+		unsigned long long x = static_cast<unsigned long long>(key);
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ull;
+		x ^= x >> 33;
+		return static_cast<size_t>(x);
+	}
+};
+
+    /**
+     * whether linked_hashmap keeps the full hash of every key in its node.
+     * With the hash cached, rehash() only redistributes nodes, erase()
+     * never calls Hash, and lookups compare hashes before calling Equal.
+     * Keys that std::hash maps to themselves, or that integral_hash hashes
+     * in a few instructions, gain nothing from it, so they opt out;
+     * specialize this for your own Key/Hash to override.
+     */
+template<class Key, class Hash>
+struct cache_hash : std::integral_constant<bool,
+	!((std::is_integral<Key>::value || std::is_enum<Key>::value || std::is_pointer<Key>::value)
+		&& std::is_same<Hash, std::hash<Key> >::value)
+	&& !((std::is_integral<Key>::value || std::is_enum<Key>::value) && std::is_same<Hash, integral_hash>::value)> {};
+
+    /**
+     * the cached hash of a node, or nothing when cache_hash is false.
+     */
+template<bool Cached>
+struct node_hash {
+	size_t hash = 0;
+};
+
+template<>
+struct node_hash<false> {};
+
+    /**
+     * true if the functor F declares is_transparent, i.e. it accepts keys
+     * of other types than the container's Key. linked_hashmap enables its
+     * heterogeneous find/count/at/erase overloads when Hash and Equal
+     * both are.
+     */
+template<class F, class = void>
+struct is_transparent : std::false_type {};
+
+template<class F>
+struct is_transparent<F, decltype(static_cast<typename F::is_transparent *>(nullptr), void())> : std::true_type {};
+
+#if __cplusplus >= 201703L
+    /**
+     * a transparent hash for std::string keys. std::string, std::string_view
+     * and C strings hash alike, so together with std::equal_to<> a
+     * linked_hashmap<std::string, T> can be searched without building a
+     * temporary std::string.
+     */
+struct string_hash {
+	typedef void is_transparent;
+
+	size_t operator()(std::string_view s) const noexcept {
+		return std::hash<std::string_view>()(s);
+	}
+};
+#endif
+
+    /**
+     * a keyed hash for keys that come from outside, where a fixed hash
+     * lets an attacker pick keys that all land in one bucket: SipHash-1-3
+     * (as in Rust's HashMap and Python's str) under a 128-bit key. A
+     * default-constructed seeded_hash draws a fresh key, so every map
+     * that owns one hashes differently from every other map and from the
+     * previous run; seeded_hash(k0, k1) fixes the key for reproducible
+     * tests. Strings of every kind and integral or enum keys are hashed;
+     * it is transparent, so, with std::equal_to<>, a
+     * linked_hashmap<std::string, T, seeded_hash> is searched by C string
+     * or string_view without a temporary std::string.
+     *
+     * Being stateful, it makes linked_hashmap cache every hash, and merge()
+     * and insert(node_type) rehash the nodes they take from another map.
+     */
+class seeded_hash {
+public:
+	typedef void is_transparent;
+
+	seeded_hash() {
+		unsigned long long seed = next_seed();
+		k0 = mix(seed);
+		k1 = mix(seed + 0x9E3779B97F4A7C15ull);
+	}
+
+	seeded_hash(unsigned long long k0, unsigned long long k1) : k0(k0), k1(k1) {}
+
+	size_t operator()(const std::string &s) const noexcept {
+		return bytes(s.data(), s.size());
+	}
+
+	size_t operator()(const char *s) const noexcept {
+		return bytes(s, std::strlen(s));
+	}
+
+#if __cplusplus >= 201703L
+	size_t operator()(std::string_view s) const noexcept {
+		return bytes(s.data(), s.size());
+	}
+#endif
+
+	template<class I, class = typename std::enable_if<std::is_integral<I>::value || std::is_enum<I>::value>::type>
+	size_t operator()(I key) const noexcept {
+		unsigned long long value = static_cast<unsigned long long>(key);
+		return bytes(&value, sizeof(value));
+	}
+
+	// SipHash-1-3 of the n bytes at data, read in native byte order
+	size_t bytes(const void *data, size_t n) const noexcept {
+		const unsigned char *in = static_cast<const unsigned char *>(data);
+		unsigned long long v0 = k0 ^ 0x736f6d6570736575ull;
+		unsigned long long v1 = k1 ^ 0x646f72616e646f6dull;
+		unsigned long long v2 = k0 ^ 0x6c7967656e657261ull;
+		unsigned long long v3 = k1 ^ 0x7465646279746573ull;
+		size_t i = 0;
+		for (; i + 8 <= n; i += 8) {
+			unsigned long long m;
+			std::memcpy(&m, in + i, 8);
+			v3 ^= m;
+			round(v0, v1, v2, v3);
+			v0 ^= m;
+		}
+		unsigned long long last = static_cast<unsigned long long>(n) << 56;
+		for (size_t shift = 0; i < n; ++i, shift += 8) {
+			last |= static_cast<unsigned long long>(in[i]) << shift;
+		}
+		v3 ^= last;
+		round(v0, v1, v2, v3);
+		v0 ^= last;
+		v2 ^= 0xff;
+		round(v0, v1, v2, v3);
+		round(v0, v1, v2, v3);
+		round(v0, v1, v2, v3);
+		return static_cast<size_t>(v0 ^ v1 ^ v2 ^ v3);
+	}
+
+private:
+	unsigned long long k0, k1;
+
+	static unsigned long long rotate(unsigned long long x, int bits) {
+		return (x << bits) | (x >> (64 - bits));
+	}
+
+	static void round(unsigned long long &v0, unsigned long long &v1, unsigned long long &v2,
+		unsigned long long &v3) {
+		v0 += v1;
+		v1 = rotate(v1, 13);
+		v1 ^= v0;
+		v0 = rotate(v0, 32);
+		v2 += v3;
+		v3 = rotate(v3, 16);
+		v3 ^= v2;
+		v0 += v3;
+		v3 = rotate(v3, 21);
+		v3 ^= v0;
+		v2 += v1;
+		v1 = rotate(v1, 17);
+		v1 ^= v2;
+		v2 = rotate(v2, 32);
+	}
+
+	// splitmix64's finalizer
+	static unsigned long long mix(unsigned long long x) {
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+		return x ^ (x >> 31);
+	}
+
+	// a process-wide random start, stepped for every new key, so that two
+	// maps built in the same clock tick still differ
+	static unsigned long long next_seed() {
+		static std::atomic<unsigned long long> state(initial_seed());
+		return state.fetch_add(0x632BE59BD9B4E019ull, std::memory_order_relaxed);
+	}
+
+	static unsigned long long initial_seed() {
+		unsigned long long seed = static_cast<unsigned long long>(
+			std::chrono::steady_clock::now().time_since_epoch().count());
+		seed ^= reinterpret_cast<std::uintptr_t>(&seed);
+		try {
+			std::random_device device;
+			seed ^= static_cast<unsigned long long>(device()) << 32 | device();
+		} catch (...) {
+			// no entropy source: the clock and the address have to do
+		}
+		return mix(seed);
+	}
+};
+
+    /**
+     * Statistics policies of linked_hashmap, its last template argument.
+     *
+     * no_stats, the default, records nothing and compiles to the plain
+     * code paths. A policy with `static const bool enabled = true` is
+     * kept in the map and told about the hot paths through
+     *   on_find(probes)       a lookup (find, count, at, erase by key...);
+     *   on_insert(probes)     the lookup of an insertion;
+     *   on_rehash(buckets, nanoseconds)
+     *                         a rebuild of the index and its duration;
+     *   on_buckets(buckets)   the bucket count, on construction and after
+     *                         every rebuild;
+     *   on_allocate()         a node allocation;
+     *   on_deallocate(n)      n nodes released.
+     * probes is the number of elements the lookup compared keys with:
+     * every node of the chain for the chained engines, only the
+     * fingerprint matches for the open-addressing ones. Lookups through a
+     * const map record too, so a map with stats must not be read from
+     * several threads at once. linked_hashmap::stats() returns a copy of
+     * the policy object.
+     */
+struct no_stats {
+	static const bool enabled = false;
+};
+
+    /**
+     * a stats policy counting into plain fields, ready to be exported.
+     * Histogram bin 0 counts lookups that compared no key, bin b > 0
+     * those that compared between 2^(b-1) and 2^b - 1 keys; the last bin
+     * takes everything beyond.
+     */
+struct linked_hashmap_stats {
+	static const bool enabled = true;
+	static const size_t BINS = 16;
+
+	size_t find_probes[BINS] = {};
+	size_t insert_probes[BINS] = {};
+	size_t max_probes = 0; // the longest lookup seen
+	size_t rehashes = 0;
+	unsigned long long rehash_nanoseconds = 0;
+	size_t peak_bucket_count = 0;
+	size_t allocations = 0;
+	size_t deallocations = 0;
+
+	static size_t bin(size_t probes) {
+		size_t b = 0;
+		while (probes && b + 1 < BINS) {
+			probes >>= 1;
+			++b;
+		}
+		return b;
+	}
+
+	void on_find(size_t probes) {
+		++find_probes[bin(probes)];
+		record_max(probes);
+	}
+
+	void on_insert(size_t probes) {
+		++insert_probes[bin(probes)];
+		record_max(probes);
+	}
+
+	void on_rehash(size_t buckets, unsigned long long nanoseconds) {
+		++rehashes;
+		rehash_nanoseconds += nanoseconds;
+		on_buckets(buckets);
+	}
+
+	void on_buckets(size_t buckets) {
+		if (buckets > peak_bucket_count) {
+			peak_bucket_count = buckets;
+		}
+	}
+
+	void on_allocate() {
+		++allocations;
+	}
+
+	void on_deallocate(size_t n) {
+		deallocations += n;
+	}
+
+private:
+	void record_max(size_t probes) {
+		if (probes > max_probes) {
+			max_probes = probes;
+		}
+	}
+};
+
+    /**
+     * what linked_hashmap::memory_usage() reports, in bytes:
+     *   index  the arrays of the engine's index;
+     *   nodes  the nodes of the elements, one each;
+     *   spare  node memory held but not in use: the free blocks and the
+     *          unused slab space of a pool_allocator, and the kept nodes
+     *          under SJTU_LINKED_HASHMAP_ITERATOR_CHECKS 2. Other
+     *          allocators give a node back when it is erased.
+     * Neither the map object itself nor what the elements own (the
+     * buffer of a std::string) is counted.
+     */
+struct linked_hashmap_memory {
+	size_t index;
+	size_t nodes;
+	size_t spare;
+
+	size_t total() const {
+		return index + nodes + spare;
+	}
+};
+
+    /**
+     * whether threads that own disjoint bucket ranges may insert into the
+     * index of Engine at once, which index<Node>::bucket(hash) gives.
+     * Only fixed chained tables guarantee it: probing crosses ranges, and
+     * an incremental migration touches both tables on every update.
+     */
+template<class Engine>
+struct partitioned_insert : std::false_type {};
+
+template<class Indexing>
+struct partitioned_insert<chained_buckets<Indexing> > : std::true_type {};
+
+    /**
+     * the policy object of a map whose policy is enabled, or nothing.
+     */
+template<class Stats, bool Enabled = Stats::enabled>
+struct stats_recorder {
+	mutable Stats recorder;
+};
+
+template<class Stats>
+struct stats_recorder<Stats, false> {};
+
+    /**
+     * In linked_hashmap, iteration ordering is differ from map,
+     * which is the order in which keys were inserted into the map.
+     * You should maintain a doubly-linked list running through all
+     * of its entries to keep the correct iteration order.
+     *
+     * Note that insertion order is not affected if a key is re-inserted
+     * into the map.
+     */
+    
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>,
+	class Allocator = pool_allocator<pair<const Key, T> >,
+	class Engine = SJTU_LINKED_HASHMAP_DEFAULT_ENGINE,
+	class Stats = no_stats
+> class linked_hashmap : private stats_recorder<Stats> {
+private:
+	typedef cache_hash<Key, Hash> hash_cached;
+	typedef std::integral_constant<bool, Stats::enabled> stats_enabled;
+
+	// the insertion-order links. The list is circular through the map's
+	// sentinel, which is where end() points, so an iterator finds its
+	// way back from end() without knowing its map.
+	struct list_hook {
+		list_hook* list_next; // next in insertion order
+		list_hook* list_prev; // prev in insertion order
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+		size_t generation; // bumped whenever the element leaves the map
+#endif
+
+		list_hook() : list_hook(nullptr, nullptr) {}
+
+		list_hook(list_hook* next, list_hook* prev) : list_next(next), list_prev(prev) {
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+			generation = 0;
+#endif
+		}
+	};
+
+	// Node structure: the order links, engine links for the hash index
+	// and the cached hash (if any)
+	struct Node : list_hook, Engine::template node_base<Node>, node_hash<hash_cached::value> {
+		pair<const Key, T> data;
+
+		// data is built in place from whatever pair's constructors accept
+		template<class... Args>
+		explicit Node(Args&&... args) : list_hook(), data(std::forward<Args>(args)...) {}
+	};
+
+	typedef typename Engine::template node_base<Node> index_hook;
+	typedef typename std::allocator_traits<Allocator>::template rebind_alloc<Node> node_allocator;
+	typedef std::allocator_traits<node_allocator> node_traits;
+	typedef typename Engine::template index<Node> index_type;
+	// whether a copy may take its nodes as one run from the allocator and
+	// fill them with memcpy
+	typedef std::integral_constant<bool, std::is_trivially_copyable<pair<const Key, T> >::value
+		&& has_bulk_run<node_allocator>::value> bulk_clone;
+
+	// a move copies the hasher and key_equal, which the moved-from map
+	// keeps, and moves the allocator; the index, list and stats are only
+	// swapped. swap() moves Hash and Equal through std::swap, and
+	// allocators never throw on swap.
+	typedef std::integral_constant<bool, std::is_nothrow_copy_constructible<Hash>::value
+		&& std::is_nothrow_copy_constructible<Equal>::value
+		&& std::is_nothrow_move_constructible<node_allocator>::value> nothrow_move;
+	typedef std::integral_constant<bool, std::is_nothrow_move_constructible<Hash>::value
+		&& std::is_nothrow_move_assignable<Hash>::value && std::is_nothrow_move_constructible<Equal>::value
+		&& std::is_nothrow_move_assignable<Equal>::value> nothrow_swap;
+
+	// Hash table parameters
+	static const size_t INITIAL_CAPACITY = 16;
+	// A map built without a bucket count starts with no index at all and
+	// finds keys by walking its order list, which for a handful of nodes
+	// beats hashing into a table; the index is built once it grows past
+	// SMALL_SIZE elements, or when a bucket count is asked for.
+	static const size_t SMALL_SIZE = 8;
+	static const size_t BATCH = 16; // keys hashed and prefetched ahead by the bulk operations
+	static const float LOAD_FACTOR; // default max_load_factor()
+
+	index_type table;
+	size_t element_count;
+	float max_load;
+	float min_load; // min_load_factor(), 0 if the index never shrinks
+
+	// Doubly linked list for insertion order
+	list_hook sentinel{&sentinel, &sentinel};
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+	list_hook* graveyard = nullptr; // erased nodes, their values destroyed, kept for reuse
+#endif
+
+	Hash hasher;
+	Equal key_equal;
+	node_allocator alloc;
+
+	// Helper functions
+	template<class... Args>
+	Node* create_node(Args&&... args) {
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+		if (graveyard) {
+			Node* node = static_cast<Node*>(graveyard);
+			::new (static_cast<void*>(&node->data)) value_type(std::forward<Args>(args)...);
+			graveyard = node->list_next;
+			note_allocate(stats_enabled());
+			return node;
+		}
+#endif
+		Node* node = node_traits::allocate(alloc, 1);
+		try {
+			node_traits::construct(alloc, node, std::forward<Args>(args)...);
+		} catch (...) {
+			node_traits::deallocate(alloc, node, 1);
+			throw;
+		}
+		note_allocate(stats_enabled());
+		return node;
+	}
+
+	void destroy_node(Node* node) {
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+		bury(node);
+#else
+		node_traits::destroy(alloc, node);
+		node_traits::deallocate(alloc, node, 1);
+		note_deallocate(1, stats_enabled());
+#endif
+	}
+
+	// destroys every node in the insertion list and returns their memory,
+	// in one go when the allocator supports it and shares its pool with no
+	// one; nodes with nothing to destroy are then not visited at all
+	void destroy_all_nodes() {
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+		// the order list is left as it is; clear() resets it
+		for (Node* current = first_node(); current;) {
+			Node* next = next_node(current);
+			bury(current);
+			current = next;
+		}
+#else
+		bool bulk = releasable(has_bulk_release<node_allocator>());
+		if (bulk) {
+			note_deallocate(element_count, stats_enabled());
+		}
+		if (bulk && std::is_trivially_destructible<Node>::value) {
+			release_nodes(has_bulk_release<node_allocator>());
+			return;
+		}
+		Node* current = first_node();
+		while (current) {
+			Node* next = next_node(current);
+			if (next) {
+				SJTU_LINKED_HASHMAP_CHAIN_HINT(next->list_next);
+			}
+			if (bulk) {
+				node_traits::destroy(alloc, current);
+			} else {
+				destroy_node(current);
+			}
+			current = next;
+		}
+		if (bulk) {
+			release_nodes(has_bulk_release<node_allocator>());
+		}
+#endif
+	}
+
+	bool releasable(std::true_type) const {
+		return alloc.unshared();
+	}
+
+	bool releasable(std::false_type) const {
+		return false;
+	}
+
+	void release_nodes(std::true_type) {
+		alloc.release();
+	}
+
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+	// destroys the value of node and keeps the node, with a new
+	// generation, so that iterators to it can tell they are stale; the
+	// statistics count it as freed all the same
+	void bury(Node* node) {
+		++node->generation;
+		node->data.~value_type();
+		note_deallocate(1, stats_enabled());
+		node->list_next = graveyard;
+		graveyard = node;
+	}
+
+	// frees the buried nodes; no iterator to them may be used afterwards
+	void free_graveyard() {
+		while (graveyard) {
+			Node* node = static_cast<Node*>(graveyard);
+			graveyard = node->list_next;
+			node_traits::deallocate(alloc, node, 1);
+		}
+	}
+#endif
+
+	void release_nodes(std::false_type) {}
+
+	void reserve_nodes(size_t n, std::true_type) {
+		alloc.reserve(n);
+	}
+
+	void reserve_nodes(size_t, std::false_type) {}
+
+	// heterogeneous lookups with K need both functors to be transparent;
+	// plain Key lookups use the non-template overloads
+	template<class K>
+	struct transparent_lookup : std::integral_constant<bool,
+		is_transparent<Hash>::value && is_transparent<Equal>::value> {};
+
+	template<class K>
+	size_t hash_key(const K& key) const {
+		return hasher(key);
+	}
+
+	size_t hash_of(const Node* node) const {
+		return node_hash_of(node, hash_cached());
+	}
+
+	size_t node_hash_of(const Node* node, std::true_type) const {
+		return node->hash;
+	}
+
+	size_t node_hash_of(const Node* node, std::false_type) const {
+		return hasher(node->data.first);
+	}
+
+	void store_hash(Node* node, size_t hash) {
+		store_hash(node, hash, hash_cached());
+	}
+
+	void store_hash(Node* node, size_t hash, std::true_type) {
+		node->hash = hash;
+	}
+
+	void store_hash(Node*, size_t, std::false_type) {}
+
+	// a cheap filter before Equal; always passes without a cached hash
+	bool same_hash(const Node* node, size_t hash) const {
+		return same_hash(node, hash, hash_cached());
+	}
+
+	bool same_hash(const Node* node, size_t hash, std::true_type) const {
+		return node->hash == hash;
+	}
+
+	bool same_hash(const Node*, size_t, std::false_type) const {
+		return true;
+	}
+
+	// Statistics: these do nothing unless the Stats policy is enabled
+	void note_allocate(std::true_type) const {
+		this->recorder.on_allocate();
+	}
+
+	void note_allocate(std::false_type) const {}
+
+	void note_deallocate(size_t n, std::true_type) const {
+		this->recorder.on_deallocate(n);
+	}
+
+	void note_deallocate(size_t, std::false_type) const {}
+
+	void note_buckets(std::true_type) const {
+		this->recorder.on_buckets(table.bucket_count());
+	}
+
+	void note_buckets(std::false_type) const {}
+
+	// whether the index is built; a small map has none yet (see SMALL_SIZE)
+	bool indexed() const {
+		return table.bucket_count() != 0;
+	}
+
+	// a small map's lookup: walks the order list, calling seen on each node
+	template<class K, class Seen>
+	Node* find_listed(const K& key, size_t hash, Seen seen) const {
+		for (Node* node = first_node(); node; node = next_node(node)) {
+			seen(node);
+			if (same_hash(node, hash) && key_equal(node->data.first, key)) {
+				return node;
+			}
+		}
+		return nullptr;
+	}
+
+	// looks key up in the index given its precomputed hash; inserting
+	// tells the stats which histogram the lookup belongs to
+	template<class K>
+	Node* find_node(const K& key, size_t hash, bool inserting = false) const {
+		return find_node(key, hash, inserting, stats_enabled());
+	}
+
+	template<class K>
+	Node* find_node(const K& key, size_t hash, bool, std::false_type) const {
+		if (!indexed()) {
+			return find_listed(key, hash, [](const Node*) {});
+		}
+		return table.find(hash, [this, &key, hash](const Node* node) {
+			return same_hash(node, hash) && key_equal(node->data.first, key);
+		});
+	}
+
+	template<class K>
+	Node* find_node(const K& key, size_t hash, bool inserting, std::true_type) const {
+		size_t probes = 0;
+		Node* found;
+		if (!indexed()) {
+			found = find_listed(key, hash, [&probes](const Node*) { ++probes; });
+		} else {
+			found = table.find(hash, [this, &key, hash, &probes](const Node* node) {
+				++probes;
+				return same_hash(node, hash) && key_equal(node->data.first, key);
+			});
+		}
+		if (inserting) {
+			this->recorder.on_insert(probes);
+		} else {
+			this->recorder.on_find(probes);
+		}
+		return found;
+	}
+
+	// hands the engine a way to recompute (or read back) node hashes
+	struct node_hasher {
+		const linked_hashmap* map;
+		size_t operator()(const Node* node) const {
+			return map->hash_of(node);
+		}
+	};
+
+	void rebuild(size_t new_capacity) {
+		rebuild(new_capacity, stats_enabled());
+	}
+
+	void rebuild(size_t new_capacity, std::false_type) {
+		rehash_index(new_capacity);
+	}
+
+	void rebuild(size_t new_capacity, std::true_type) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		rehash_index(new_capacity);
+		std::chrono::nanoseconds spent = std::chrono::steady_clock::now() - start;
+		this->recorder.on_rehash(table.bucket_count(), static_cast<unsigned long long>(spent.count()));
+	}
+
+	// resizes the index, building it from the order list when the map
+	// leaves small mode; a build that throws leaves the map small
+	void rehash_index(size_t new_capacity) {
+		bool building = !indexed();
+		table.rehash(new_capacity, node_hasher{this});
+		if (!building) {
+			return;
+		}
+		try {
+			// the engine has no entries to size itself by yet
+			while (table.load_limit(max_load) < element_count) {
+				table.rehash(table.bucket_count() * 2, node_hasher{this});
+			}
+			for (Node* node = first_node(); node; node = next_node(node)) {
+				table.insert(node, hash_of(node));
+			}
+		} catch (...) {
+			index_type small(0);
+			table.swap(small);
+			throw;
+		}
+	}
+
+	// rebuilds the index with at least buckets buckets, then as fit_index()
+	void rebuild_for(size_t buckets, size_t n) {
+		rebuild(buckets);
+		fit_index(n);
+	}
+
+	// doubles the index until the engine's own ceiling, which may be
+	// below max_load (see load_limit), admits n elements
+	void fit_index(size_t n) {
+		while (indexed() && table.load_limit(max_load) < n) {
+			rebuild(table.bucket_count() * 2);
+		}
+	}
+
+	void migrate() {
+		table.migrate(node_hasher{this});
+	}
+
+	// goes back to small mode, which needs no index
+	void drop_index() {
+		index_type small(0);
+		table.swap(small);
+		note_buckets(stats_enabled());
+	}
+
+	// rebuilds the index at half max_load once erasing has taken it below
+	// min_load; an index that cannot allocate the smaller table stays
+	void shrink_if_sparse() {
+		if (!indexed() || !(element_count < min_load * table.bucket_count())) {
+			return;
+		}
+		size_t wanted = buckets_for(element_count * 2);
+		if (wanted < INITIAL_CAPACITY) {
+			wanted = INITIAL_CAPACITY;
+		}
+		if (wanted >= table.bucket_count()) {
+			return;
+		}
+		try {
+			rebuild_for(wanted, element_count);
+		} catch (const std::bad_alloc &) {
+		}
+	}
+
+	// the index shrink_to_fit() leaves: none for a small map
+	size_t fitting_buckets() const {
+		return element_count > SMALL_SIZE ? buckets_for(element_count) : 0;
+	}
+
+	void shrink_index() {
+		size_t buckets = fitting_buckets();
+		if (!buckets) {
+			drop_index();
+		} else if (indexed()) {
+			rebuild_for(buckets, element_count);
+		}
+	}
+
+	void shrink_nodes(std::false_type) {
+		shrink_index();
+	}
+
+	// the elements move to a fresh allocator in one batch, with an index
+	// that fits them, and the old allocator goes with all of its slabs.
+	// Moving is only safe once the allocator has set aside every node.
+	void shrink_nodes(std::true_type) {
+		typedef std::integral_constant<bool, has_bulk_reserve<node_allocator>::value
+			&& std::is_nothrow_move_constructible<value_type>::value> by_move;
+		linked_hashmap fresh(fitting_buckets(), hasher, key_equal,
+			Allocator(node_traits::select_on_container_copy_construction(alloc)));
+		fresh.max_load = max_load;
+		fresh.min_load = min_load;
+		fresh.fit_index(element_count);
+		fresh.reserve_nodes(element_count, has_bulk_reserve<node_allocator>());
+		for (Node* node = first_node(); node; node = next_node(node)) {
+			fresh.link_node(fresh.create_node(relocated(node, by_move())), hash_of(node));
+		}
+		swap(fresh);
+		swap_stats(fresh, stats_enabled()); // the records stay with this map
+		note_buckets(stats_enabled());
+	}
+
+	static pair<const Key, T>&& relocated(Node* node, std::true_type) {
+		return std::move(node->data);
+	}
+
+	static const pair<const Key, T>& relocated(Node* node, std::false_type) {
+		return node->data;
+	}
+
+	size_t spare_bytes(std::true_type) const {
+		size_t held = alloc.footprint();
+		size_t used = element_count * sizeof(Node);
+		return held > used ? held - used : 0;
+	}
+
+	size_t spare_bytes(std::false_type) const {
+		size_t kept = 0;
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+		for (const list_hook* hook = graveyard; hook; hook = hook->list_next) {
+			++kept;
+		}
+#endif
+		return kept * sizeof(Node);
+	}
+
+	// the bucket count that holds n elements within max_load
+	size_t buckets_for(size_t n) const {
+		return static_cast<size_t>(std::ceil(n / static_cast<double>(max_load)));
+	}
+
+	// the node that owns hook, or nullptr for the sentinel
+	Node* node_at(list_hook* hook) const {
+		return hook == &sentinel ? nullptr : static_cast<Node*>(hook);
+	}
+
+	// the oldest and the newest node, nullptr if the map is empty
+	Node* first_node() const {
+		return node_at(sentinel.list_next);
+	}
+
+	Node* last_node() const {
+		return node_at(sentinel.list_prev);
+	}
+
+	// the node after node in insertion order, nullptr after the newest
+	Node* next_node(const Node* node) const {
+		return node_at(node->list_next);
+	}
+
+	list_hook* end_hook() const {
+		return const_cast<list_hook*>(&sentinel);
+	}
+
+	void reset_list() {
+		sentinel.list_next = sentinel.list_prev = &sentinel;
+	}
+
+	// exchanges the order lists of two maps, pointing the ends of each
+	// list at its new sentinel
+	void swap_list(linked_hashmap& other) {
+		std::swap(sentinel.list_next, other.sentinel.list_next);
+		std::swap(sentinel.list_prev, other.sentinel.list_prev);
+		adopt_list(&other.sentinel);
+		other.adopt_list(&sentinel);
+	}
+
+	void adopt_list(const list_hook* old_sentinel) {
+		if (sentinel.list_next == old_sentinel) {
+			reset_list();
+		} else {
+			sentinel.list_next->list_prev = &sentinel;
+			sentinel.list_prev->list_next = &sentinel;
+		}
+	}
+
+	// appends a node that is in no list to the back of the order list
+	void append_to_list(Node* node) {
+		node->list_prev = sentinel.list_prev;
+		node->list_next = &sentinel;
+		sentinel.list_prev->list_next = node;
+		sentinel.list_prev = node;
+	}
+
+	// takes node out of the order list, leaving its own links dangling
+	void unlink_from_list(Node* node) {
+		node->list_prev->list_next = node->list_next;
+		node->list_next->list_prev = node->list_prev;
+	}
+
+	// stores the hash and hooks a fresh node into the index and the order list
+	void link_node(Node* node, size_t hash) {
+		store_hash(node, hash);
+		if (indexed()) {
+			table.insert(node, hash);
+		}
+		append_to_list(node);
+		++element_count;
+	}
+
+	// inserts a node built from args unless key is present; args are not
+	// touched when it is. returns the node holding key and whether it is new.
+	//
+	// This is the only probe: the table grows after a miss, and since
+	// engines place a new node from its hash alone, that needs no second
+	// lookup.
+	template<class... Args>
+	pair<Node*, bool> emplace_unique(const Key& key, Args&&... args) {
+		return emplace_hashed(key, hash_key(key), std::forward<Args>(args)...);
+	}
+
+	// emplace_unique() for a key whose hash is known already
+	template<class... Args>
+	pair<Node*, bool> emplace_hashed(const Key& key, size_t hash, Args&&... args) {
+		migrate();
+
+		// Check if key already exists
+		Node* existing = find_node(key, hash, true);
+		if (existing) {
+			return pair<Node*, bool>(existing, false);
+		}
+
+		ensure_capacity();
+		Node* node = create_node(std::forward<Args>(args)...);
+		link_node(node, hash);
+		return pair<Node*, bool>(node, true);
+	}
+
+	// copies other into this empty map, whose index already has other's
+	// bucket count, with no new hashing (when hashes are cached), no
+	// duplicate probe and no growth check, since other's elements already
+	// fit its table. Slots are prefetched BATCH nodes ahead, as by the
+	// bulk inserts.
+	void clone_from(const linked_hashmap& other) {
+		clone_from(other, bulk_clone());
+	}
+
+	// the nodes come out of the allocator as one batch and go straight to
+	// the bucket other keeps them in, in insertion order
+	void clone_from(const linked_hashmap& other, std::false_type) {
+		reserve_nodes(other.element_count, has_bulk_reserve<node_allocator>());
+		const Node* pending[BATCH];
+		size_t hashes[BATCH];
+		const Node* node = other.first_node();
+		while (node) {
+			size_t n = 0;
+			for (; n < BATCH && node; ++n, node = other.next_node(node)) {
+				pending[n] = node;
+				hashes[n] = other.hash_of(node);
+				if (indexed()) {
+					table.prefetch(hashes[n]);
+				}
+			}
+			for (size_t i = 0; i < n; ++i) {
+				link_node(create_node(pending[i]->data), hashes[i]);
+			}
+		}
+	}
+
+	// trivially copyable elements: the nodes are one run, an array in
+	// insertion order, copied with one memcpy per stretch of other's nodes
+	// that lie next to each other (a single one for a map that was only
+	// ever inserted into, or copied). The copied links are then reset in
+	// one pass over the run, which also builds the index.
+	void clone_from(const linked_hashmap& other, std::true_type) {
+		size_t n = other.element_count;
+		Node* run = n ? alloc.allocate_run(n) : nullptr;
+		if (!run) {
+			clone_from(other, std::false_type());
+			return;
+		}
+		Node* to = run;
+		for (const Node* from = other.first_node(); from;) {
+			size_t length = 1;
+			const Node* next = other.next_node(from);
+			while (next && next == from + length) {
+				++length;
+				next = other.next_node(next);
+			}
+			std::memcpy(static_cast<void*>(to), static_cast<const void*>(from), length * sizeof(Node));
+			to += length;
+			from = next;
+		}
+		size_t hashes[BATCH];
+		for (size_t start = 0; start < n; start += BATCH) {
+			size_t stop = start + BATCH < n ? start + BATCH : n;
+			for (size_t i = start; i < stop; ++i) {
+				Node* node = run + i;
+				static_cast<list_hook&>(*node) = list_hook(i + 1 < n ? node + 1 : end_hook(),
+					i ? static_cast<list_hook*>(node - 1) : end_hook());
+				static_cast<index_hook&>(*node) = index_hook();
+				if (indexed()) {
+					hashes[i - start] = hash_of(node);
+					table.prefetch(hashes[i - start]);
+				}
+				note_allocate(stats_enabled());
+			}
+			if (indexed()) {
+				for (size_t i = start; i < stop; ++i) {
+					table.insert(run + i, hashes[i - start]);
+				}
+			}
+		}
+		sentinel.list_next = run;
+		sentinel.list_prev = run + (n - 1);
+		element_count = n;
+	}
+
+	// unlinks node from the index and the order list, leaving it allocated
+	void unlink_node(Node* node) {
+		// Remove from hash index
+		if (indexed()) {
+			table.erase(node, hash_of(node));
+			migrate();
+		}
+
+		unlink_from_list(node);
+		--element_count;
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+		++node->generation;
+#endif
+		if (min_load > 0) {
+			shrink_if_sparse();
+		}
+	}
+
+	// unlinks node and frees it
+	void erase_node(Node* node) {
+		unlink_node(node);
+		destroy_node(node);
+	}
+
+	// erases the run of the order list from first up to stop, or up to
+	// the end, whichever comes first; returns how many were erased. The
+	// nodes leave the index through their hashes, with their slots
+	// prefetched BATCH nodes ahead, and the list is cut once per batch
+	// rather than once per node.
+	size_t erase_run(Node* first, const list_hook* stop) {
+		if (first == first_node() && stop == end_hook()) {
+			size_t erased = element_count;
+			clear();
+			return erased;
+		}
+		size_t erased = 0;
+		list_hook* before = first->list_prev;
+		list_hook* current = first;
+		while (current != stop && current != end_hook()) {
+			Node* pending[BATCH];
+			size_t hashes[BATCH];
+			size_t n = 0;
+			for (; n < BATCH && current != stop && current != end_hook(); ++n, current = current->list_next) {
+				pending[n] = static_cast<Node*>(current);
+				if (indexed()) {
+					hashes[n] = hash_of(pending[n]);
+					table.prefetch(hashes[n]);
+				}
+			}
+			for (size_t i = 0; i < n; ++i) {
+				if (indexed()) {
+					table.erase(pending[i], hashes[i]);
+					migrate();
+				}
+				destroy_node(pending[i]);
+			}
+			before->list_next = current;
+			current->list_prev = before;
+			element_count -= n;
+			erased += n;
+		}
+		if (min_load > 0) {
+			shrink_if_sparse();
+		}
+		return erased;
+	}
+
+	// the hash of a node built by another map of this type: its cached
+	// hash holds here too unless Hash carries state, such as a seed
+	size_t adopted_hash(const Node* node) const {
+		return std::is_empty<Hash>::value ? hash_of(node) : hash_key(node->data.first);
+	}
+
+
+	void ensure_capacity() {
+		if (!indexed()) {
+			if (element_count >= SMALL_SIZE) {
+				size_t needed = buckets_for(element_count + 1);
+				rebuild(needed > INITIAL_CAPACITY ? needed : INITIAL_CAPACITY);
+			}
+			return;
+		}
+		size_t limit = table.load_limit(max_load);
+		if (table.occupancy(element_count) >= limit) {
+			if (element_count >= limit / 2) {
+				size_t doubled = table.bucket_count() * 2;
+				size_t needed = buckets_for(element_count + 1);
+				rebuild(doubled > needed ? doubled : needed);
+			} else {
+				// a table mostly full of tombstones is rebuilt at the same size
+				rebuild(table.bucket_count());
+			}
+		}
+	}
+
+public:
+	/**
+	 * the internal type of data.
+	 * it should have a default constructor, a copy constructor.
+	 * You can use sjtu::linked_hashmap as value_type by typedef.
+	 */
+	typedef pair<const Key, T> value_type;
+ 
+	/**
+	 * see BidirectionalIterator at CppReference for help.
+	 *
+	 * if there is anything wrong throw invalid_iterator.
+	 *     like it = linked_hashmap.begin(); --it;
+	 *       or it = linked_hashmap.end(); ++end();
+	 */
+	friend class iterator;
+	friend class const_iterator;
+
+	/**
+	 * what both iterators hold: the node they point to, or the sentinel
+	 * at end(), and as much as SJTU_LINKED_HASHMAP_ITERATOR_CHECKS asks
+	 * them to check it by (see there).
+	 */
+	struct iterator_base {
+		list_hook* current;
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 1
+		const linked_hashmap* container;
+#endif
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+		size_t generation; // that of current when the iterator got there
+#endif
+
+		iterator_base() : current(nullptr) {
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 1
+			container = nullptr;
+#endif
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+			generation = 0;
+#endif
+		}
+
+		// node == nullptr stands for end()
+		iterator_base(const Node* node, const linked_hashmap* cont)
+			: current(node ? static_cast<list_hook*>(const_cast<Node*>(node)) : cont->end_hook()) {
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 1
+			container = cont;
+#endif
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+			generation = current->generation;
+#endif
+		}
+
+		// throws unless the iterator points into a map, at an element or,
+		// if at_end allows, at end(), and has not been invalidated
+		void check(bool at_end) const {
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 1
+			if (!current || (!at_end && current == &container->sentinel)) {
+				throw invalid_iterator();
+			}
+#endif
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+			if (current->generation != generation) {
+				throw invalid_iterator();
+			}
+#endif
+			(void)at_end;
+		}
+
+		void moved() {
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+			generation = current->generation;
+#endif
+		}
+
+		void forward() {
+			check(false);
+			current = current->list_next;
+			SJTU_LINKED_HASHMAP_CHAIN_HINT(current->list_next);
+			moved();
+		}
+
+		void backward() {
+			check(true);
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 1
+			if (current->list_prev == &container->sentinel) {
+				throw invalid_iterator();
+			}
+#endif
+			current = current->list_prev;
+			moved();
+		}
+
+		Node* node() const {
+			check(false);
+			return static_cast<Node*>(current);
+		}
+	};
+
+	class const_iterator;
+	class iterator : public iterator_base {
+	public:
+		iterator(Node* node, const linked_hashmap* cont) : iterator_base(node, cont) {}
+		// The following code is written for the C++ type_traits library.
+		// Type traits is a C++ feature for describing certain properties of a type.
+		// For instance, for an iterator, iterator::value_type is the type that the
+		// iterator points to.
+		// STL algorithms and containers may use these type_traits (e.g. the following
+		// typedef) to work properly.
+		// See these websites for more information:
+		// https://en.cppreference.com/w/cpp/header/type_traits
+		// About value_type: https://blog.csdn.net/u014299153/article/details/72419713
+		// About iterator_category: https://en.cppreference.com/w/cpp/iterator
+		using difference_type = std::ptrdiff_t;
+		using value_type = typename linked_hashmap::value_type;
+		using pointer = value_type*;
+		using reference = value_type&;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+		iterator() {}
+		iterator(const iterator &other) : iterator_base(other) {}
+		iterator & operator=(const iterator &other) = default;
+
+		/**
+		 * TODO iter++
+		 */
+		iterator operator++(int) {
+			iterator temp = *this;
+			++*this;
+			return temp;
+		}
+		/**
+		 * TODO ++iter
+		 */
+		iterator & operator++() {
+			this->forward();
+			return *this;
+		}
+		/**
+		 * TODO iter--
+		 */
+		iterator operator--(int) {
+			iterator temp = *this;
+			--*this;
+			return temp;
+		}
+		/**
+		 * TODO --iter
+		 */
+		iterator & operator--() {
+			this->backward();
+			return *this;
+		}
+		/**
+		 * a operator to check whether two iterators are same (pointing to the same memory).
+		 */
+		value_type & operator*() const {
+			return this->node()->data;
+		}
+		bool operator==(const iterator &rhs) const {
+			return this->current == rhs.current;
+		}
+		bool operator==(const const_iterator &rhs) const {
+			return this->current == rhs.current;
+		}
+		/**
+		 * some other operator for iterator.
+		 */
+		bool operator!=(const iterator &rhs) const {
+			return this->current != rhs.current;
+		}
+		bool operator!=(const const_iterator &rhs) const {
+			return this->current != rhs.current;
+		}
+
+		/**
+		 * for the support of it->first.
+		 * See <http://kelvinh.github.io/blog/2013/11/20/overloading-of-member-access-operator-dash-greater-than-symbol-in-cpp/> for help.
+		 */
+		value_type* operator->() const {
+			return &(this->node()->data);
+		}
+	};
+ 
+	class const_iterator : public iterator_base {
+	public:
+		const_iterator(const Node* node, const linked_hashmap* cont) : iterator_base(node, cont) {}
+		using difference_type = std::ptrdiff_t;
+		using value_type = const typename linked_hashmap::value_type;
+		using pointer = value_type*;
+		using reference = value_type&;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+		const_iterator() {}
+		const_iterator(const const_iterator &other) : iterator_base(other) {}
+		const_iterator(const iterator &other) : iterator_base(other) {}
+		const_iterator & operator=(const const_iterator &other) = default;
+
+		const_iterator operator++(int) {
+			const_iterator temp = *this;
+			++*this;
+			return temp;
+		}
+
+		const_iterator & operator++() {
+			this->forward();
+			return *this;
+		}
+
+		const_iterator operator--(int) {
+			const_iterator temp = *this;
+			--*this;
+			return temp;
+		}
+
+		const_iterator & operator--() {
+			this->backward();
+			return *this;
+		}
+
+		const value_type & operator*() const {
+			return this->node()->data;
+		}
+
+		bool operator==(const const_iterator &rhs) const {
+			return this->current == rhs.current;
+		}
+
+		bool operator==(const iterator &rhs) const {
+			return this->current == rhs.current;
+		}
+
+		bool operator!=(const const_iterator &rhs) const {
+			return this->current != rhs.current;
+		}
+
+		bool operator!=(const iterator &rhs) const {
+			return this->current != rhs.current;
+		}
+
+		const value_type* operator->() const {
+			return &(this->node()->data);
+		}
+	};
+
+	/**
+	 * an element taken out of a map by extract(), together with its node.
+	 * The handle owns the node until insert() hands it to a map again, or
+	 * frees it when dropped. Moving a handle moves only the pointer.
+	 *
+	 * key(), mapped() and value() throw container_is_empty on an empty
+	 * handle.
+	 */
+	class node_type {
+	public:
+		typedef Key key_type;
+		typedef T mapped_type;
+
+		node_type() : node(nullptr) {}
+
+		node_type(node_type &&other) : node(other.node), alloc(std::move(other.alloc)) {
+			other.node = nullptr;
+		}
+
+		node_type & operator=(node_type &&other) {
+			if (this != &other) {
+				reset();
+				alloc = std::move(other.alloc);
+				node = other.node;
+				other.node = nullptr;
+			}
+			return *this;
+		}
+
+		node_type(const node_type &) = delete;
+		node_type & operator=(const node_type &) = delete;
+
+		~node_type() {
+			reset();
+		}
+
+		bool empty() const {
+			return !node;
+		}
+
+		explicit operator bool() const {
+			return node != nullptr;
+		}
+
+		const Key & key() const {
+			return value().first;
+		}
+
+		T & mapped() const {
+			return value().second;
+		}
+
+		value_type & value() const {
+			if (!node) {
+				throw container_is_empty();
+			}
+			return node->data;
+		}
+
+		void swap(node_type &other) {
+			std::swap(node, other.node);
+			using std::swap;
+			swap(alloc, other.alloc);
+		}
+
+		friend void swap(node_type &lhs, node_type &rhs) {
+			lhs.swap(rhs);
+		}
+
+	private:
+		friend class linked_hashmap;
+
+		Node* node;
+		node_allocator alloc; // frees node; a copy of the allocator of the map it left
+
+		explicit node_type(const node_allocator &alloc) : node(nullptr), alloc(alloc) {}
+
+		void reset() {
+			if (node) {
+				node_traits::destroy(alloc, node);
+				node_traits::deallocate(alloc, node, 1);
+				node = nullptr;
+			}
+		}
+	};
+
+	/**
+	 * the result of insert(node_type &&): where the key is, whether the
+	 * handle's element went in, and the handle itself if it did not.
+	 */
+	struct insert_return_type {
+		iterator position;
+		bool inserted;
+		node_type node;
+	};
+ 
+	/**
+	 * TODO two constructors
+	 */
+	linked_hashmap() : table(0), element_count(0), max_load(LOAD_FACTOR), min_load(0) {
+		note_buckets(stats_enabled());
+	}
+
+	/**
+	 * constructs an empty map with at least bucket_count buckets,
+	 * so that it can be filled without rehashing.
+	 */
+	explicit linked_hashmap(size_t bucket_count, const Hash &hash = Hash(), const Equal &equal = Equal(),
+		const Allocator &allocator = Allocator())
+		: table(bucket_count), element_count(0), max_load(LOAD_FACTOR), min_load(0),
+		hasher(hash), key_equal(equal), alloc(allocator) {
+		note_buckets(stats_enabled());
+	}
+
+	/**
+	 * a map of the elements of [first, last), built by parallel_insert()
+	 * on threads threads.
+	 */
+	template<class RandomIt, typename std::enable_if<std::is_base_of<std::random_access_iterator_tag,
+		typename std::iterator_traits<RandomIt>::iterator_category>::value, int>::type = 0>
+	linked_hashmap(RandomIt first, RandomIt last, size_t threads) : linked_hashmap() {
+		parallel_insert(first, last, threads);
+	}
+
+	linked_hashmap(const linked_hashmap &other) : table(other.table.bucket_count()), element_count(0), max_load(other.max_load),
+		min_load(other.min_load), hasher(other.hasher), key_equal(other.key_equal),
+		alloc(node_traits::select_on_container_copy_construction(other.alloc)) {
+		note_buckets(stats_enabled());
+		try {
+			clone_from(other);
+		} catch (...) {
+			clear();
+			throw;
+		}
+	}
+
+	/**
+	 * takes over the elements, the index and the allocator of other,
+	 * which is left empty. It throws nothing unless copying Hash or
+	 * Equal, or moving the allocator, can.
+	 */
+	linked_hashmap(linked_hashmap &&other) noexcept(nothrow_move::value) : table(0), element_count(0), max_load(other.max_load),
+		min_load(other.min_load), hasher(other.hasher), key_equal(other.key_equal), alloc(std::move(other.alloc)) {
+		table.swap(other.table);
+		std::swap(element_count, other.element_count);
+		swap_list(other);
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+		std::swap(graveyard, other.graveyard);
+#endif
+		swap_stats(other, stats_enabled());
+	}
+
+	/**
+	 * TODO assignment operator
+	 */
+	linked_hashmap & operator=(const linked_hashmap &other) {
+		if (this != &other) {
+			linked_hashmap temp(other);
+			swap(temp);
+		}
+		return *this;
+	}
+
+	linked_hashmap & operator=(linked_hashmap &&other) noexcept(nothrow_move::value && nothrow_swap::value) {
+		if (this != &other) {
+			linked_hashmap temp(std::move(other));
+			swap(temp);
+		}
+		return *this;
+	}
+
+	void swap(linked_hashmap &other) noexcept(nothrow_swap::value) {
+		table.swap(other.table);
+		std::swap(element_count, other.element_count);
+		std::swap(max_load, other.max_load);
+		std::swap(min_load, other.min_load);
+		swap_list(other);
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+		std::swap(graveyard, other.graveyard);
+#endif
+		std::swap(hasher, other.hasher);
+		std::swap(key_equal, other.key_equal);
+		using std::swap;
+		swap(alloc, other.alloc);
+		swap_stats(other, stats_enabled());
+	}
+
+	Hash hash_function() const {
+		return hasher;
+	}
+
+	Equal key_eq() const {
+		return key_equal;
+	}
+
+	/**
+	 * a copy of what the Stats policy has recorded so far, to be exported
+	 * as it is; an empty no_stats unless stats are enabled. The records
+	 * go with the contents on swap and move, and a copy starts afresh.
+	 */
+	Stats stats() const {
+		return stats(stats_enabled());
+	}
+
+	/**
+	 * starts the records over, e.g. after exporting them.
+	 */
+	void reset_stats() {
+		reset_stats(stats_enabled());
+	}
+
+private:
+	void swap_stats(linked_hashmap &other, std::true_type) {
+		using std::swap;
+		swap(this->recorder, other.recorder);
+	}
+
+	void swap_stats(linked_hashmap &, std::false_type) {}
+
+	Stats stats(std::true_type) const {
+		return this->recorder;
+	}
+
+	Stats stats(std::false_type) const {
+		return Stats();
+	}
+
+	void reset_stats(std::true_type) {
+		this->recorder = Stats();
+		note_buckets(stats_enabled());
+	}
+
+	void reset_stats(std::false_type) {}
+
+public:
+
+	/**
+	 * TODO Destructors
+	 */
+	~linked_hashmap() {
+		clear();
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 2
+		free_graveyard();
+#endif
+	}
+ 
+	/**
+	 * TODO
+	 * access specified element with bounds checking
+	 * Returns a reference to the mapped value of the element with key equivalent to key.
+	 * If no such element exists, an exception of type `index_out_of_bound'
+	 */
+	T & at(const Key &key) {
+		iterator it = find(key);
+		if (it == end()) {
+			throw index_out_of_bound();
+		}
+		return it->second;
+	}
+
+	const T & at(const Key &key) const {
+		const_iterator it = find(key);
+		if (it == cend()) {
+			throw index_out_of_bound();
+		}
+		return it->second;
+	}
+
+	template<class K, typename std::enable_if<transparent_lookup<K>::value, int>::type = 0>
+	T & at(const K &key) {
+		Node* node = find_node(key, hash_key(key));
+		if (!node) {
+			throw index_out_of_bound();
+		}
+		return node->data.second;
+	}
+
+	template<class K, typename std::enable_if<transparent_lookup<K>::value, int>::type = 0>
+	const T & at(const K &key) const {
+		const Node* node = find_node(key, hash_key(key));
+		if (!node) {
+			throw index_out_of_bound();
+		}
+		return node->data.second;
+	}
+
+	/**
+	 * TODO
+	 * access specified element
+	 * Returns a reference to the value that is mapped to a key equivalent to key,
+	 *   performing an insertion if such key does not already exist.
+	 */
+	T & operator[](const Key &key) {
+		return emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first->data.second;
+	}
+
+	T & operator[](Key &&key) {
+		return emplace_unique(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)), std::tuple<>()).first->data.second;
+	}
+
+	/**
+	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 */
+	const T & operator[](const Key &key) const {
+		return at(key);
+	}
+
+	/**
+	 * at() without the exception: a pointer to the value mapped to key,
+	 * or nullptr if there is none. A miss costs the lookup and nothing else.
+	 */
+	T * get(const Key &key) {
+		Node* node = find_node(key, hash_key(key));
+		return node ? &node->data.second : nullptr;
+	}
+
+	const T * get(const Key &key) const {
+		const Node* node = find_node(key, hash_key(key));
+		return node ? &node->data.second : nullptr;
+	}
+
+	template<class K, typename std::enable_if<transparent_lookup<K>::value, int>::type = 0>
+	T * get(const K &key) {
+		Node* node = find_node(key, hash_key(key));
+		return node ? &node->data.second : nullptr;
+	}
+
+	template<class K, typename std::enable_if<transparent_lookup<K>::value, int>::type = 0>
+	const T * get(const K &key) const {
+		const Node* node = find_node(key, hash_key(key));
+		return node ? &node->data.second : nullptr;
+	}
+
+	/**
+	 * copies the value mapped to key into out. returns false, leaving out
+	 * alone, if key is not present.
+	 */
+	bool try_get(const Key &key, T &out) const {
+		const T* value = get(key);
+		if (!value) {
+			return false;
+		}
+		out = *value;
+		return true;
+	}
+
+	template<class K, typename std::enable_if<transparent_lookup<K>::value, int>::type = 0>
+	bool try_get(const K &key, T &out) const {
+		const T* value = get(key);
+		if (!value) {
+			return false;
+		}
+		out = *value;
+		return true;
+	}
+
+	/**
+	 * return a iterator to the beginning
+	 */
+	iterator begin() {
+		return iterator(first_node(), this);
+	}
+
+	const_iterator cbegin() const {
+		return const_iterator(first_node(), this);
+	}
+
+	/**
+	 * return a iterator to the end
+	 * in fact, it returns past-the-end.
+	 */
+	iterator end() {
+		return iterator(nullptr, this);
+	}
+
+	const_iterator cend() const {
+		return const_iterator(nullptr, this);
+	}
+
+	/**
+	 * checks whether the container is empty
+	 * return true if empty, otherwise false.
+	 */
+	bool empty() const {
+		return element_count == 0;
+	}
+
+	/**
+	 * returns the number of elements.
+	 */
+	size_t size() const {
+		return element_count;
+	}
+
+	/**
+	 * returns the number of buckets (slots for the open-addressing engines).
+	 */
+	size_t bucket_count() const {
+		return table.bucket_count();
+	}
+
+	/**
+	 * returns the average number of elements per bucket.
+	 */
+	float load_factor() const {
+		if (!indexed()) {
+			return 0;
+		}
+		return static_cast<float>(element_count) / table.bucket_count();
+	}
+
+	/**
+	 * the load factor beyond which the table grows, 0.75 by default.
+	 * Open-addressing engines cap it internally so probes stay bounded.
+	 */
+	float max_load_factor() const {
+		return max_load;
+	}
+
+	void max_load_factor(float ml) {
+		if (!(ml > 0) || ml < 4 * min_load) {
+			throw runtime_error();
+		}
+		max_load = ml;
+		if (indexed() && element_count > table.load_limit(max_load)) {
+			rebuild_for(buckets_for(element_count), element_count);
+		}
+	}
+
+	/**
+	 * the load factor below which erasing shrinks the index; 0, the
+	 * default, never shrinks it. A shrink rebuilds the index at half
+	 * max_load_factor(), far from both limits, so a size that hovers
+	 * around either does not rebuild it over and over; for the same
+	 * reason ml may be at most a quarter of max_load_factor(). Once ml
+	 * is set, clear() drops the index as well. Nodes stay where they
+	 * are, and so do iterators; see shrink_to_fit() for the nodes.
+	 */
+	float min_load_factor() const {
+		return min_load;
+	}
+
+	void min_load_factor(float ml) {
+		if (!(ml >= 0) || ml > max_load / 4) {
+			throw runtime_error();
+		}
+		min_load = ml;
+		shrink_if_sparse();
+	}
+
+	/**
+	 * sets the number of buckets to at least count and at least
+	 * size() / max_load_factor(), rebuilding the index. An engine whose
+	 * ceiling is lower than max_load_factor() gets as many more as it
+	 * needs to hold size() elements.
+	 */
+	void rehash(size_t count) {
+		size_t needed = buckets_for(element_count);
+		rebuild_for(count > needed ? count : needed, element_count);
+	}
+
+	/**
+	 * makes room for at least count elements without further rehashing.
+	 */
+	void reserve(size_t count) {
+		if (!indexed() && count <= SMALL_SIZE) {
+			return;
+		}
+		if (count > table.load_limit(max_load)) {
+			rebuild_for(buckets_for(count), count);
+		}
+	}
+
+	/**
+	 * gives back the memory the map holds beyond what its elements need.
+	 * The index is rebuilt for size() elements, or dropped if the map is
+	 * small enough to do without one, and with a pool_allocator the
+	 * elements move into a single slab of size() nodes while the old
+	 * slabs are freed. Invalidates every iterator, pointer and reference
+	 * to the elements, as reallocation does for std::vector. Elements
+	 * are moved if that cannot throw and copied otherwise; if a copy
+	 * throws, the map is left as it was.
+	 */
+	void shrink_to_fit() {
+		shrink_nodes(has_bulk_release<node_allocator>());
+	}
+
+	/**
+	 * the bytes the map's index and nodes take; see linked_hashmap_memory.
+	 */
+	linked_hashmap_memory memory_usage() const {
+		linked_hashmap_memory usage;
+		usage.index = table.memory();
+		usage.nodes = element_count * sizeof(Node);
+		usage.spare = spare_bytes(has_footprint<node_allocator>());
+		return usage;
+	}
+
+	/**
+	 * clears the contents
+	 */
+	void clear() {
+		destroy_all_nodes();
+		reset_list();
+		element_count = 0;
+
+		// Clear buckets
+		if (min_load > 0) {
+			drop_index();
+		} else {
+			table.clear();
+		}
+	}
+ 
+private:
+	pair<iterator, bool> to_result(const pair<Node*, bool> &result) {
+		return pair<iterator, bool>(iterator(result.first, this), result.second);
+	}
+
+	// the node pos points to; throws unless that is an element of this map
+	Node* node_of(const iterator_base &pos) const {
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 1
+		if (pos.container != this) {
+			throw invalid_iterator();
+		}
+#endif
+		return pos.node();
+	}
+
+	// the hook pos points to, at an element or at end(); throws unless
+	// that is in this map
+	list_hook* hook_of(const iterator_base &pos) const {
+#if SJTU_LINKED_HASHMAP_ITERATOR_CHECKS >= 1
+		if (pos.container != this) {
+			throw invalid_iterator();
+		}
+#endif
+		pos.check(true);
+		return pos.current;
+	}
+
+public:
+	/**
+	 * insert an element.
+	 * return a pair, the first of the pair is
+	 *   the iterator to the new element (or the element that prevented the insertion),
+	 *   the second one is true if insert successfully, or false.
+	 */
+	pair<iterator, bool> insert(const value_type &value) {
+		return to_result(emplace_unique(value.first, value));
+	}
+
+	pair<iterator, bool> insert(value_type &&value) {
+		return to_result(emplace_unique(value.first, std::move(value)));
+	}
+
+	/**
+	 * inserts every element of [first, last) that does not share its key
+	 * with an element already present, in range order.
+	 *
+	 * With forward iterators the table is first reserved for the whole
+	 * range, so it never grows midway, and keys are hashed and their
+	 * slots prefetched BATCH at a time ahead of the inserts.
+	 */
+	template<class InputIt>
+	void insert(InputIt first, InputIt last) {
+		insert_range(first, last, typename std::iterator_traits<InputIt>::iterator_category());
+	}
+
+private:
+	template<class InputIt>
+	void insert_range(InputIt first, InputIt last, std::input_iterator_tag) {
+		for (; first != last; ++first) {
+			insert(*first);
+		}
+	}
 
-		const_iterator operator++(int) {
-			const_iterator temp = *this;
-			if (current) {
-				current = current->list_next;
+	template<class ForwardIt>
+	void insert_range(ForwardIt first, ForwardIt last, std::forward_iterator_tag) {
+		// at least doubling, like ensure_capacity(), so that a series of
+		// small ranges does not rebuild the index every time
+		size_t wanted = element_count + static_cast<size_t>(std::distance(first, last));
+		if ((indexed() || wanted > SMALL_SIZE) && wanted > table.load_limit(max_load)) {
+			size_t doubled = table.bucket_count() * 2;
+			size_t needed = buckets_for(wanted);
+			rebuild(doubled > needed ? doubled : needed);
+		}
+		ForwardIt pending[BATCH];
+		size_t hashes[BATCH];
+		while (first != last) {
+			size_t n = 0;
+			for (; n < BATCH && first != last; ++n, ++first) {
+				pending[n] = first;
+				hashes[n] = hash_key((*first).first);
+				if (indexed()) {
+					table.prefetch(hashes[n]);
+				}
+			}
+			for (size_t i = 0; i < n; ++i) {
+				emplace_hashed((*pending[i]).first, hashes[i], *pending[i]);
 			}
-			return temp;
 		}
+	}
 
-		const_iterator & operator++() {
-			if (current) {
-				current = current->list_next;
-			}
-			return *this;
+	// the threads to use when asked for threads (0: one per hardware
+	// thread), no more than there are items of work
+	static size_t threads_for(size_t threads, size_t work) {
+		if (threads == 0) {
+			threads = std::thread::hardware_concurrency();
+		}
+		if (threads > work) {
+			threads = work;
 		}
+		return threads ? threads : 1;
+	}
 
-		const_iterator operator--(int) {
-			const_iterator temp = *this;
-			if (current) {
-				current = current->list_prev;
+	// runs f(0) ... f(parts - 1) at once, f(0) on the calling thread. Parts
+	// no thread could be started for run on the calling thread as well.
+	// Once all are done, the first exception any part threw is rethrown.
+	template<class F>
+	static void run_parallel(size_t parts, F &f) {
+		std::unique_ptr<std::exception_ptr[]> errors(new std::exception_ptr[parts]);
+		std::unique_ptr<std::thread[]> workers(new std::thread[parts]);
+		size_t started = 1;
+		try {
+			for (; started < parts; ++started) {
+				std::exception_ptr *error = &errors[started];
+				size_t part = started;
+				workers[started] = std::thread([&f, error, part]() {
+					try {
+						f(part);
+					} catch (...) {
+						*error = std::current_exception();
+					}
+				});
 			}
-			return temp;
+		} catch (...) {
+			// out of threads: the calling thread runs the rest
 		}
-
-		const_iterator & operator--() {
-			if (current) {
-				current = current->list_prev;
+		try {
+			f(0);
+		} catch (...) {
+			errors[0] = std::current_exception();
+		}
+		for (size_t i = started; i < parts; ++i) {
+			try {
+				f(i);
+			} catch (...) {
+				errors[i] = std::current_exception();
 			}
-			return *this;
 		}
-
-		const value_type & operator*() const {
-			return current->data;
+		for (size_t i = 1; i < started; ++i) {
+			workers[i].join();
 		}
-
-		bool operator==(const const_iterator &rhs) const {
-			return current == rhs.current;
+		for (size_t i = 0; i < parts; ++i) {
+			if (errors[i]) {
+				std::rethrow_exception(errors[i]);
+			}
 		}
+	}
 
-		bool operator==(const iterator &rhs) const {
-			return current == rhs.current;
+	// the first node of each of parts runs of the order list as equal as
+	// can be, followed by nullptr
+	void split_list(Node** bounds, size_t parts) const {
+		size_t per = element_count / parts;
+		size_t extra = element_count % parts;
+		Node* node = first_node();
+		for (size_t t = 0; t < parts; ++t) {
+			bounds[t] = node;
+			for (size_t i = per + (t < extra ? 1 : 0); i > 0; --i) {
+				node = next_node(node);
+			}
 		}
+		bounds[parts] = nullptr;
+	}
 
-		bool operator!=(const const_iterator &rhs) const {
-			return current != rhs.current;
-		}
+	// what parallel_insert() has done to each node
+	enum build_state : unsigned char { ALLOCATED, BUILT, LINKED, DUPLICATE };
 
-		bool operator!=(const iterator &rhs) const {
-			return current != rhs.current;
-		}
+	// links the built nodes into the index, each thread the nodes of its
+	// own range of buckets, in input order within it
+	void index_nodes(Node** nodes, const size_t* hashes, unsigned char* state, size_t n, size_t parts, std::true_type) {
+		size_t buckets = table.bucket_count();
+		auto link = [this, nodes, hashes, state, n, parts, buckets](size_t t) {
+			for (size_t i = 0; i < n; ++i) {
+				if (static_cast<unsigned long long>(table.bucket(hashes[i])) * parts / buckets != t) {
+					continue;
+				}
+				// the stats are not safe to record from several threads
+				if (find_node(nodes[i]->data.first, hashes[i], true, std::false_type())) {
+					state[i] = DUPLICATE;
+				} else {
+					store_hash(nodes[i], hashes[i]);
+					table.insert(nodes[i], hashes[i]);
+					state[i] = LINKED;
+				}
+			}
+		};
+		run_parallel(parts, link);
+	}
 
-		const value_type* operator->() const noexcept {
-			return &(current->data);
+	// the same, on one thread, for engines whose inserts interfere
+	void index_nodes(Node** nodes, const size_t* hashes, unsigned char* state, size_t n, size_t, std::false_type) {
+		for (size_t i = 0; i < n; ++i) {
+			if (find_node(nodes[i]->data.first, hashes[i], true)) {
+				state[i] = DUPLICATE;
+			} else {
+				store_hash(nodes[i], hashes[i]);
+				table.insert(nodes[i], hashes[i]);
+				state[i] = LINKED;
+			}
 		}
-	};
- 
+	}
+
+public:
+
 	/**
-	 * TODO two constructors
+	 * constructs an element from args directly in a new node and inserts it.
+	 * The node is built first to learn its key, and dropped again if
+	 * the key already exists; prefer try_emplace() when the key is at hand.
 	 */
-	linked_hashmap() : bucket_count(INITIAL_CAPACITY), element_count(0), head(nullptr), tail(nullptr) {
-		buckets = new Node*[bucket_count]();
-	}
+	template<class... Args>
+	pair<iterator, bool> emplace(Args&&... args) {
+		migrate();
 
-	linked_hashmap(const linked_hashmap &other) : bucket_count(other.bucket_count), element_count(0), head(nullptr), tail(nullptr) {
-		buckets = new Node*[bucket_count]();
+		Node* node = create_node(std::forward<Args>(args)...);
+		size_t hash;
 		try {
-			for (const_iterator it = other.cbegin(); it != other.cend(); ++it) {
-				insert(*it);
+			hash = hash_key(node->data.first);
+			Node* existing = find_node(node->data.first, hash, true);
+			if (existing) {
+				destroy_node(node);
+				return pair<iterator, bool>(iterator(existing, this), false);
 			}
+			ensure_capacity();
 		} catch (...) {
-			clear();
-			delete[] buckets;
+			destroy_node(node);
 			throw;
 		}
+		link_node(node, hash);
+		return pair<iterator, bool>(iterator(node, this), true);
 	}
 
 	/**
-	 * TODO assignment operator
+	 * inserts key with a mapped value constructed in place from args.
+	 * If key already exists nothing is constructed and args are left alone.
 	 */
-	linked_hashmap & operator=(const linked_hashmap &other) {
-		if (this != &other) {
-			linked_hashmap temp(other);
-			swap(temp);
-		}
-		return *this;
+	template<class... Args>
+	pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+		return to_result(emplace_unique(key, std::piecewise_construct,
+			std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)));
 	}
 
-	void swap(linked_hashmap &other) {
-		std::swap(buckets, other.buckets);
-		std::swap(bucket_count, other.bucket_count);
-		std::swap(element_count, other.element_count);
-		std::swap(head, other.head);
-		std::swap(tail, other.tail);
+	template<class... Args>
+	pair<iterator, bool> try_emplace(Key &&key, Args&&... args) {
+		return to_result(emplace_unique(key, std::piecewise_construct,
+			std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...)));
 	}
 
 	/**
-	 * TODO Destructors
-	 */
-	~linked_hashmap() {
-		clear();
-		delete[] buckets;
-	}
- 
-	/**
-	 * TODO
-	 * access specified element with bounds checking
-	 * Returns a reference to the mapped value of the element with key equivalent to key.
-	 * If no such element exists, an exception of type `index_out_of_bound'
+	 * inserts (key, obj), or assigns obj to the mapped value if key exists.
+	 * the second of the result is true if an insertion took place.
 	 */
-	T & at(const Key &key) {
-		iterator it = find(key);
-		if (it == end()) {
-			throw index_out_of_bound();
-		}
-		return it->second;
-	}
-
-	const T & at(const Key &key) const {
-		const_iterator it = find(key);
-		if (it == cend()) {
-			throw index_out_of_bound();
+	template<class M>
+	pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+		pair<iterator, bool> result = try_emplace(key, std::forward<M>(obj));
+		if (!result.second) {
+			result.first->second = std::forward<M>(obj);
 		}
-		return it->second;
+		return result;
 	}
 
-	/**
-	 * TODO
-	 * access specified element
-	 * Returns a reference to the value that is mapped to a key equivalent to key,
-	 *   performing an insertion if such key does not already exist.
-	 */
-	T & operator[](const Key &key) {
-		iterator it = find(key);
-		if (it != end()) {
-			return it->second;
+	template<class M>
+	pair<iterator, bool> insert_or_assign(Key &&key, M &&obj) {
+		pair<iterator, bool> result = try_emplace(std::move(key), std::forward<M>(obj));
+		if (!result.second) {
+			result.first->second = std::forward<M>(obj);
 		}
-		pair<iterator, bool> result = insert(value_type(key, T()));
-		return result.first->second;
+		return result;
 	}
 
 	/**
-	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 * erase the element at pos.
+	 *
+	 * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
 	 */
-	const T & operator[](const Key &key) const {
-		return at(key);
+	void erase(iterator pos) {
+		erase_node(node_of(pos));
 	}
 
 	/**
-	 * return a iterator to the beginning
+	 * moves the element at pos to the back of the iteration order, as if
+	 * it had just been inserted. Only the order links change: the element
+	 * is neither rehashed nor reallocated, and every iterator stays valid.
+	 *
+	 * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
 	 */
-	iterator begin() {
-		return iterator(head, this);
-	}
-
-	const_iterator cbegin() const {
-		return const_iterator(head, this);
+	void move_to_back(iterator pos) {
+		Node* node = node_of(pos);
+		if (node != sentinel.list_prev) {
+			unlink_from_list(node);
+			append_to_list(node);
+		}
 	}
 
 	/**
-	 * return a iterator to the end
-	 * in fact, it returns past-the-end.
+	 * takes the element at pos out of the map and returns it in a node
+	 * handle. When the handle's allocator, a copy of ours, can free our
+	 * nodes (std::allocator, pool_allocator, shared_pool_allocator) the
+	 * node itself moves to the handle: nothing is allocated, copied or
+	 * rehashed. With an allocator whose copies compare unequal, the
+	 * element is moved into a node of the handle's own instead.
+	 *
+	 * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
 	 */
-	iterator end() {
-		return iterator(nullptr, this);
-	}
-
-	const_iterator cend() const {
-		return const_iterator(nullptr, this);
+	node_type extract(const_iterator pos) {
+		Node* node = node_of(pos);
+		node_type handle(alloc);
+		if (handle.alloc == alloc) {
+			unlink_node(node);
+			handle.node = node;
+			return handle;
+		}
+		Node* moved = node_traits::allocate(handle.alloc, 1);
+		try {
+			node_traits::construct(handle.alloc, moved, std::move(node->data));
+		} catch (...) {
+			node_traits::deallocate(handle.alloc, moved, 1);
+			throw;
+		}
+		store_hash(moved, hash_of(node));
+		handle.node = moved;
+		erase_node(node);
+		return handle;
 	}
 
 	/**
-	 * checks whether the container is empty
-	 * return true if empty, otherwise false.
+	 * extracts the element with key equivalent to key; the handle is
+	 * empty if there is none.
 	 */
-	bool empty() const {
-		return element_count == 0;
+	node_type extract(const Key &key) {
+		Node* node = find_node(key, hash_key(key));
+		if (!node) {
+			return node_type(alloc);
+		}
+		return extract(const_iterator(node, this));
 	}
 
 	/**
-	 * returns the number of elements.
+	 * inserts the element of nh at the back of the iteration order unless
+	 * its key is present, in which case nh comes back in the result. A
+	 * node whose allocator equals ours is linked in as it is, reusing its
+	 * cached hash when Hash is stateless; any other is moved into a new
+	 * node. An empty nh inserts nothing.
 	 */
-	size_t size() const {
-		return element_count;
+	insert_return_type insert(node_type &&nh) {
+		if (nh.empty()) {
+			return insert_return_type{end(), false, node_type(alloc)};
+		}
+		migrate();
+		size_t hash = adopted_hash(nh.node);
+		Node* existing = find_node(nh.node->data.first, hash, true);
+		if (existing) {
+			return insert_return_type{iterator(existing, this), false, std::move(nh)};
+		}
+		ensure_capacity();
+		Node* node;
+		if (nh.alloc == alloc) {
+			node = nh.node;
+			nh.node = nullptr;
+			link_node(node, hash);
+		} else {
+			node = create_node(std::move(nh.node->data));
+			nh.reset();
+			link_node(node, hash);
+		}
+		return insert_return_type{iterator(node, this), true, node_type(alloc)};
 	}
 
 	/**
-	 * clears the contents
+	 * moves every element of source whose key is not present here to the
+	 * back of this map, in source's order; the others stay in source.
+	 * Nodes are relinked, without allocating or copying, when the two
+	 * maps' allocators compare equal, and moved into new nodes otherwise.
+	 * Iterators to the moved elements are invalidated.
 	 */
-	void clear() {
-		Node* current = head;
+	void merge(linked_hashmap &source) {
+		if (&source == this) {
+			return;
+		}
+		bool relink = alloc == source.alloc;
+		Node* current = source.first_node();
 		while (current) {
-			Node* next = current->list_next;
-			delete current;
+			Node* next = source.next_node(current);
+			migrate();
+			size_t hash = adopted_hash(current);
+			if (!find_node(current->data.first, hash, true)) {
+				ensure_capacity();
+				if (relink) {
+					source.unlink_node(current);
+					link_node(current, hash);
+				} else {
+					link_node(create_node(std::move(current->data)), hash);
+					source.erase_node(current);
+				}
+			}
 			current = next;
 		}
-		head = tail = nullptr;
-		element_count = 0;
+	}
 
-		// Clear buckets
-		for (size_t i = 0; i < bucket_count; ++i) {
-			buckets[i] = nullptr;
-		}
+	void merge(linked_hashmap &&source) {
+		merge(source);
 	}
- 
+
 	/**
-	 * insert an element.
-	 * return a pair, the first of the pair is
-	 *   the iterator to the new element (or the element that prevented the insertion),
-	 *   the second one is true if insert successfully, or false.
+	 * erases every element for which pred(const value_type &) holds, in
+	 * one pass over the insertion order; returns how many were erased.
+	 * Each node leaves the index through its cached hash (if hashes are
+	 * cached) rather than through a new lookup. If pred throws, the
+	 * elements erased so far stay erased.
 	 */
-	pair<iterator, bool> insert(const value_type &value) {
-		ensure_capacity();
-
-		size_t index = hash_index(value.first);
-		Node* current = buckets[index];
-
-		// Check if key already exists
+	template<class Pred>
+	size_t erase_if(Pred pred) {
+		size_t erased = 0;
+		Node* current = first_node();
 		while (current) {
-			if (key_equal(current->data.first, value.first)) {
-				return pair<iterator, bool>(iterator(current, this), false);
+			Node* next = next_node(current);
+			if (pred(static_cast<const value_type &>(current->data))) {
+				erase_node(current);
+				++erased;
 			}
-			current = current->next;
+			current = next;
 		}
+		return erased;
+	}
 
-		// Create new node
-		Node* new_node = new Node(value);
-
-		// Insert into hash bucket
-		new_node->next = buckets[index];
-		if (buckets[index]) {
-			buckets[index]->prev = new_node;
+	/**
+	 * erases the first element in iteration order, the oldest one.
+	 *
+	 * throw container_is_empty if the map is empty
+	 */
+	void pop_front() {
+		Node* oldest = first_node();
+		if (!oldest) {
+			throw container_is_empty();
 		}
-		buckets[index] = new_node;
+		erase_node(oldest);
+	}
 
-		// Insert into linked list
-		if (!head) {
-			head = tail = new_node;
-		} else {
-			tail->list_next = new_node;
-			new_node->list_prev = tail;
-			tail = new_node;
+	/**
+	 * erases the n oldest elements, or all of them if there are fewer;
+	 * returns how many were erased. The run is cut out of the order list
+	 * in one pass, each node leaving the index through its cached hash
+	 * (if hashes are cached) rather than through a new lookup. If Hash
+	 * throws, the elements erased so far stay erased.
+	 */
+	size_t pop_front(size_t n) {
+		if (n >= element_count) {
+			return erase_run(first_node(), end_hook());
 		}
-
-		++element_count;
-		return pair<iterator, bool>(iterator(new_node, this), true);
+		list_hook* stop = sentinel.list_next;
+		for (size_t i = 0; i < n; ++i) {
+			stop = stop->list_next;
+		}
+		return n ? erase_run(first_node(), stop) : 0;
 	}
 
 	/**
-	 * erase the element at pos.
+	 * erases [first, last) in one pass, as pop_front(n) does, and returns
+	 * last. A last that does not follow first erases up to the end.
 	 *
-	 * throw if pos pointed to a bad element (pos == this->end() || pos points an element out of this)
+	 * throw invalid_iterator if first or last belongs to another map
 	 */
-	void erase(iterator pos) {
-		if (pos == end() || pos.container != this) {
-			throw invalid_iterator();
+	iterator erase_range(const_iterator first, const_iterator last) {
+		list_hook* stop = hook_of(last);
+		if (first != last) {
+			erase_run(node_of(first), stop);
 		}
+		return iterator(node_at(stop), this);
+	}
 
-		Node* node = pos.current;
+	/**
+	 * erases every element inserted (or moved to the back) before pos,
+	 * the expired front of a time-ordered map, in one pass as
+	 * pop_front(n) does; returns how many were erased.
+	 *
+	 * throw invalid_iterator if pos belongs to another map
+	 */
+	size_t erase_older_than(const_iterator pos) {
+		list_hook* stop = hook_of(pos);
+		Node* oldest = first_node();
+		return oldest && stop != oldest ? erase_run(oldest, stop) : 0;
+	}
 
-		// Remove from hash bucket
-		size_t index = hash_index(node->data.first);
-		if (node->prev) {
-			node->prev->next = node->next;
-		} else {
-			buckets[index] = node->next;
-		}
-		if (node->next) {
-			node->next->prev = node->prev;
+	/**
+	 * erases the element with key equivalent to key, if any.
+	 * returns the number of elements removed (0 or 1).
+	 */
+	size_t erase(const Key &key) {
+		Node* node = find_node(key, hash_key(key));
+		if (!node) {
+			return 0;
 		}
+		erase_node(node);
+		return 1;
+	}
 
-		// Remove from linked list
-		if (node->list_prev) {
-			node->list_prev->list_next = node->list_next;
-		} else {
-			head = node->list_next;
-		}
-		if (node->list_next) {
-			node->list_next->list_prev = node->list_prev;
-		} else {
-			tail = node->list_prev;
+	template<class K, typename std::enable_if<transparent_lookup<K>::value
+		&& !std::is_convertible<const K&, iterator>::value
+		&& !std::is_convertible<const K&, const_iterator>::value, int>::type = 0>
+	size_t erase(const K &key) {
+		Node* node = find_node(key, hash_key(key));
+		if (!node) {
+			return 0;
 		}
-
-		delete node;
-		--element_count;
+		erase_node(node);
+		return 1;
 	}
 
 	/**
@@ -513,7 +4271,12 @@ public:
 	 *     since this container does not allow duplicates.
 	 */
 	size_t count(const Key &key) const {
-		return find(key) != cend() ? 1 : 0;
+		return find_node(key, hash_key(key)) ? 1 : 0;
+	}
+
+	template<class K, typename std::enable_if<transparent_lookup<K>::value, int>::type = 0>
+	size_t count(const K &key) const {
+		return find_node(key, hash_key(key)) ? 1 : 0;
 	}
 
 	/**
@@ -523,37 +4286,248 @@ public:
 	 *   If no such element is found, past-the-end (see end()) iterator is returned.
 	 */
 	iterator find(const Key &key) {
-		size_t index = hash_index(key);
-		Node* current = buckets[index];
+		return iterator(find_node(key, hash_key(key)), this);
+	}
 
-		while (current) {
-			if (key_equal(current->data.first, key)) {
-				return iterator(current, this);
-			}
-			current = current->next;
+	const_iterator find(const Key &key) const {
+		return const_iterator(find_node(key, hash_key(key)), this);
+	}
+
+	/**
+	 * heterogeneous lookup, available when Hash and Equal are transparent:
+	 * key only has to be hashable and comparable against Key.
+	 */
+	template<class K, typename std::enable_if<transparent_lookup<K>::value, int>::type = 0>
+	iterator find(const K &key) {
+		return iterator(find_node(key, hash_key(key)), this);
+	}
+
+	template<class K, typename std::enable_if<transparent_lookup<K>::value, int>::type = 0>
+	const_iterator find(const K &key) const {
+		return const_iterator(find_node(key, hash_key(key)), this);
+	}
+
+	/**
+	 * a pair of iterators that range-for can walk.
+	 */
+	template<class It>
+	struct range {
+		It first, last;
+
+		It begin() const {
+			return first;
 		}
 
-		return end();
+		It end() const {
+			return last;
+		}
+	};
+
+	/**
+	 * the elements from the one with key equivalent to key up to the
+	 * newest, in iteration order, for a scan that resumes where an earlier
+	 * one stopped: one lookup, then plain steps along the order list. The
+	 * range is empty if key is absent. Elements inserted during the scan
+	 * are appended to the order list, so the scan reaches them too.
+	 */
+	range<iterator> iterate_from(const Key &key) {
+		range<iterator> scan = {find(key), end()};
+		return scan;
+	}
+
+	range<const_iterator> iterate_from(const Key &key) const {
+		range<const_iterator> scan = {find(key), cend()};
+		return scan;
 	}
 
-	const_iterator find(const Key &key) const {
-		size_t index = hash_index(key);
-		const Node* current = buckets[index];
+	template<class K, typename std::enable_if<transparent_lookup<K>::value, int>::type = 0>
+	range<iterator> iterate_from(const K &key) {
+		range<iterator> scan = {find(key), end()};
+		return scan;
+	}
 
-		while (current) {
-			if (key_equal(current->data.first, key)) {
-				return const_iterator(current, this);
+	template<class K, typename std::enable_if<transparent_lookup<K>::value, int>::type = 0>
+	range<const_iterator> iterate_from(const K &key) const {
+		range<const_iterator> scan = {find(key), cend()};
+		return scan;
+	}
+
+	/**
+	 * looks up every key of [first, last) and writes an iterator to its
+	 * element, or end(), to out for each; returns the advanced out.
+	 *
+	 * Keys are hashed and their slots prefetched BATCH at a time before
+	 * any of them is probed, so the cache misses of neighbouring lookups
+	 * overlap. first has to be a forward iterator.
+	 */
+	template<class ForwardIt, class OutputIt>
+	OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) {
+		ForwardIt pending[BATCH];
+		size_t hashes[BATCH];
+		while (first != last) {
+			size_t n = 0;
+			for (; n < BATCH && first != last; ++n, ++first) {
+				pending[n] = first;
+				hashes[n] = hash_key(*first);
+				if (indexed()) {
+					table.prefetch(hashes[n]);
+				}
+			}
+			for (size_t i = 0; i < n; ++i) {
+				*out = iterator(find_node(*pending[i], hashes[i]), this);
+				++out;
+			}
+		}
+		return out;
+	}
+
+	template<class ForwardIt, class OutputIt>
+	OutputIt find_batch(ForwardIt first, ForwardIt last, OutputIt out) const {
+		ForwardIt pending[BATCH];
+		size_t hashes[BATCH];
+		while (first != last) {
+			size_t n = 0;
+			for (; n < BATCH && first != last; ++n, ++first) {
+				pending[n] = first;
+				hashes[n] = hash_key(*first);
+				if (indexed()) {
+					table.prefetch(hashes[n]);
+				}
+			}
+			for (size_t i = 0; i < n; ++i) {
+				*out = const_iterator(find_node(*pending[i], hashes[i]), this);
+				++out;
+			}
+		}
+		return out;
+	}
+
+	/**
+	 * calls fn(value_type &) on every element, splitting the insertion
+	 * order into one run per thread (threads == 0: one per hardware
+	 * thread) and walking the runs at once. Within a run the elements
+	 * come in order. fn may change mapped values but must not insert or
+	 * erase; if it throws, the first exception is rethrown once every
+	 * thread has stopped.
+	 *
+	 * Finding the runs takes one walk of the list without calling fn,
+	 * which pays off when fn does more than touch each element.
+	 */
+	template<class F>
+	void parallel_for_each(size_t threads, F fn) {
+		if (element_count == 0) {
+			return;
+		}
+		size_t parts = threads_for(threads, element_count);
+		std::unique_ptr<Node*[]> bounds(new Node*[parts + 1]);
+		split_list(bounds.get(), parts);
+		Node** runs = bounds.get();
+		auto walk = [this, runs, &fn](size_t t) {
+			for (Node* node = runs[t]; node != runs[t + 1]; node = next_node(node)) {
+				fn(node->data);
 			}
-			current = current->next;
+		};
+		run_parallel(parts, walk);
+	}
+
+	template<class F>
+	void parallel_for_each(size_t threads, F fn) const {
+		if (element_count == 0) {
+			return;
 		}
+		size_t parts = threads_for(threads, element_count);
+		std::unique_ptr<Node*[]> bounds(new Node*[parts + 1]);
+		split_list(bounds.get(), parts);
+		Node** runs = bounds.get();
+		auto walk = [this, runs, &fn](size_t t) {
+			for (const Node* node = runs[t]; node != runs[t + 1]; node = next_node(node)) {
+				fn(node->data);
+			}
+		};
+		run_parallel(parts, walk);
+	}
 
-		return cend();
+	/**
+	 * inserts the elements of [first, last) as insert(first, last) does,
+	 * with the work spread over threads (threads == 0: one per hardware
+	 * thread). Elements keep the input order, and of equal keys the first
+	 * wins, whatever the number of threads.
+	 *
+	 * The nodes are allocated on the calling thread, then built and
+	 * hashed by slices of the input at once. With chained_buckets the
+	 * index is built at once as well, each thread linking the nodes of its
+	 * own range of buckets; other engines link on the calling thread. Hash,
+	 * Equal and value_type's copy constructor must be safe to call from
+	 * several threads. If anything throws, the map is left as it was.
+	 */
+	template<class RandomIt>
+	void parallel_insert(RandomIt first, RandomIt last, size_t threads = 0) {
+		static_assert(std::is_base_of<std::random_access_iterator_tag,
+			typename std::iterator_traits<RandomIt>::iterator_category>::value,
+			"parallel_insert needs random access iterators");
+		size_t n = static_cast<size_t>(last - first);
+		if (n == 0) {
+			return;
+		}
+		size_t parts = threads_for(threads, n);
+		size_t wanted = element_count + n;
+		if (table.occupancy(element_count) + n > table.load_limit(max_load)) {
+			size_t doubled = table.bucket_count() * 2;
+			size_t needed = buckets_for(wanted);
+			rebuild(doubled > needed ? doubled : needed);
+			while (table.occupancy(element_count) + n > table.load_limit(max_load)) {
+				rebuild(table.bucket_count() * 2);
+			}
+		}
+		reserve_nodes(n, has_bulk_reserve<node_allocator>());
+		std::unique_ptr<Node*[]> nodes(new Node*[n]);
+		std::unique_ptr<size_t[]> hashes(new size_t[n]);
+		std::unique_ptr<unsigned char[]> state(new unsigned char[n]());
+		size_t allocated = 0;
+		try {
+			for (; allocated < n; ++allocated) {
+				nodes[allocated] = node_traits::allocate(alloc, 1);
+				note_allocate(stats_enabled());
+			}
+			Node** built = nodes.get();
+			size_t* hashed = hashes.get();
+			unsigned char* done = state.get();
+			auto build = [this, first, built, hashed, done, n, parts](size_t t) {
+				for (size_t i = n * t / parts, end = n * (t + 1) / parts; i < end; ++i) {
+					node_traits::construct(alloc, built[i], *(first + i));
+					done[i] = BUILT;
+					hashed[i] = hash_key(built[i]->data.first);
+				}
+			};
+			run_parallel(parts, build);
+			index_nodes(built, hashed, done, n, parts, partitioned_insert<Engine>());
+		} catch (...) {
+			for (size_t i = 0; i < allocated; ++i) {
+				if (state[i] == LINKED) {
+					table.erase(nodes[i], hashes[i]);
+				}
+				if (state[i] != ALLOCATED) {
+					node_traits::destroy(alloc, nodes[i]);
+				}
+				node_traits::deallocate(alloc, nodes[i], 1);
+				note_deallocate(1, stats_enabled());
+			}
+			throw;
+		}
+		for (size_t i = 0; i < n; ++i) {
+			if (state[i] == LINKED) {
+				append_to_list(nodes[i]);
+				++element_count;
+			} else {
+				destroy_node(nodes[i]);
+			}
+		}
 	}
 };
 
 // Static member definition
-template<class Key, class T, class Hash, class Equal>
-const double linked_hashmap<Key, T, Hash, Equal>::LOAD_FACTOR = 0.75;
+template<class Key, class T, class Hash, class Equal, class Allocator, class Engine, class Stats>
+const float linked_hashmap<Key, T, Hash, Equal, Allocator, Engine, Stats>::LOAD_FACTOR = 0.75f;
 
 }
 
@@ -0,0 +1,231 @@
+/**
+ * a bounded least-recently-used cache on top of sjtu::linked_hashmap
+ */
+#ifndef SJTU_LRU_CACHE_HPP
+#define SJTU_LRU_CACHE_HPP
+
+#include <functional>
+#include <cstddef>
+#include <utility>
+#include "linked_hashmap.hpp"
+
+namespace sjtu {
+    /**
+     * lru_cache keeps at most capacity() entries in the iteration order of
+     * a linked_hashmap, which here is the access order: begin() is the
+     * least recently used entry and the one evicted next.
+     *
+     * A lookup that hits only relinks the entry to the back of the list
+     * (linked_hashmap::move_to_back), so it neither hashes the key twice
+     * nor allocates. An insertion probes the map once: the new entry is
+     * linked first and the least recently used one evicted after, so a
+     * full cache briefly holds capacity() + 1 entries and, with the
+     * default pool_allocator, the evicted block serves the next insertion.
+     *
+     * The eviction callback sees every entry that leaves the cache because
+     * of the capacity limit, just before it is destroyed. Entries removed
+     * through erase(), pop_front() or clear() are not reported.
+     */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>,
+	class Allocator = pool_allocator<pair<const Key, T> >,
+	class Engine = SJTU_LINKED_HASHMAP_DEFAULT_ENGINE
+> class lru_cache {
+public:
+	typedef linked_hashmap<Key, T, Hash, Equal, Allocator, Engine> map_type;
+	typedef typename map_type::value_type value_type;
+	typedef typename map_type::iterator iterator;
+	typedef typename map_type::const_iterator const_iterator;
+	typedef std::function<void(value_type &)> evict_callback;
+
+private:
+	map_type map;
+	size_t limit;
+	evict_callback on_evict;
+
+	// the result of one probe of the map: a hit is touched, and an
+	// insertion evicts until the cache fits again
+	pair<iterator, bool> settle(pair<iterator, bool> result) {
+		if (!result.second) {
+			map.move_to_back(result.first);
+		}
+		while (map.size() > limit) {
+			evict_front();
+		}
+		return result;
+	}
+
+	void evict_front() {
+		if (on_evict) {
+			on_evict(*map.begin());
+		}
+		map.pop_front();
+	}
+
+	iterator touch(iterator it) {
+		if (it != map.end()) {
+			map.move_to_back(it);
+		}
+		return it;
+	}
+
+public:
+	/**
+	 * an empty cache holding at most capacity entries.
+	 *
+	 * throw runtime_error if capacity is 0
+	 */
+	explicit lru_cache(size_t capacity, evict_callback on_evict = evict_callback())
+		: map(), limit(capacity), on_evict(std::move(on_evict)) {
+		if (capacity == 0) {
+			throw runtime_error();
+		}
+	}
+
+	size_t size() const {
+		return map.size();
+	}
+
+	bool empty() const {
+		return map.empty();
+	}
+
+	size_t capacity() const {
+		return limit;
+	}
+
+	/**
+	 * changes the capacity, evicting from the front until the cache fits.
+	 *
+	 * throw runtime_error if capacity is 0
+	 */
+	void set_capacity(size_t capacity) {
+		if (capacity == 0) {
+			throw runtime_error();
+		}
+		limit = capacity;
+		while (map.size() > limit) {
+			evict_front();
+		}
+	}
+
+	void set_evict_callback(evict_callback callback) {
+		on_evict = std::move(callback);
+	}
+
+	/**
+	 * finds key and marks it as the most recently used entry.
+	 * returns end() on a miss.
+	 */
+	iterator find(const Key &key) {
+		return touch(map.find(key));
+	}
+
+	/**
+	 * finds key without changing the access order.
+	 */
+	const_iterator peek(const Key &key) const {
+		return map.find(key);
+	}
+
+	size_t count(const Key &key) const {
+		return map.count(key);
+	}
+
+	/**
+	 * the value of key, which becomes the most recently used entry.
+	 *
+	 * throw index_out_of_bound if key is not cached
+	 */
+	T & at(const Key &key) {
+		iterator it = find(key);
+		if (it == map.end()) {
+			throw index_out_of_bound();
+		}
+		return it->second;
+	}
+
+	/**
+	 * at() without the exception: a pointer to the value of key, which
+	 * becomes the most recently used entry, or nullptr on a miss.
+	 */
+	T * get(const Key &key) {
+		iterator it = find(key);
+		return it == map.end() ? nullptr : &it->second;
+	}
+
+	/**
+	 * inserts value as the most recently used entry, evicting the least
+	 * recently used one if the cache is full. If the key is cached already
+	 * its value is left alone and the entry is only touched.
+	 */
+	pair<iterator, bool> insert(const value_type &value) {
+		return try_emplace(value.first, value.second);
+	}
+
+	template<class... Args>
+	pair<iterator, bool> try_emplace(const Key &key, Args&&... args) {
+		return settle(map.try_emplace(key, std::forward<Args>(args)...));
+	}
+
+	/**
+	 * stores obj under key as the most recently used entry, replacing the
+	 * value if the key is cached already.
+	 */
+	template<class M>
+	pair<iterator, bool> insert_or_assign(const Key &key, M &&obj) {
+		return settle(map.insert_or_assign(key, std::forward<M>(obj)));
+	}
+
+	void erase(iterator pos) {
+		map.erase(pos);
+	}
+
+	size_t erase(const Key &key) {
+		return map.erase(key);
+	}
+
+	/**
+	 * drops the least recently used entry without calling the callback.
+	 *
+	 * throw container_is_empty if the cache is empty
+	 */
+	void pop_front() {
+		map.pop_front();
+	}
+
+	/**
+	 * marks the entry at pos as the most recently used one.
+	 */
+	void move_to_back(iterator pos) {
+		map.move_to_back(pos);
+	}
+
+	void clear() {
+		map.clear();
+	}
+
+	// iteration runs from the least to the most recently used entry
+	iterator begin() {
+		return map.begin();
+	}
+
+	const_iterator cbegin() const {
+		return map.cbegin();
+	}
+
+	iterator end() {
+		return map.end();
+	}
+
+	const_iterator cend() const {
+		return map.cend();
+	}
+};
+
+}
+
+#endif
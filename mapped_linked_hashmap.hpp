@@ -0,0 +1,605 @@
+/**
+ * binary snapshots of sjtu::linked_hashmap, and a read-only view that
+ * serves lookups straight from a mapped snapshot
+ */
+#ifndef SJTU_MAPPED_LINKED_HASHMAP_HPP
+#define SJTU_MAPPED_LINKED_HASHMAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <type_traits>
+#include <vector>
+#include "linked_hashmap.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SJTU_LINKED_HASHMAP_POSIX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace sjtu {
+    /**
+     * The snapshot format: a flat image that holds no pointers, so that it
+     * can be used wherever it is mapped.
+     *
+     *   snapshot_header
+     *   the entries, from entries_offset on: count snapshot_entry records
+     *     in insertion order, each with the element's hash, the index of
+     *     the next entry of its bucket chain and the element itself;
+     *   the buckets, from buckets_offset on: bucket_count 64-bit indices
+     *     of the first entry of each chain.
+     * Indices run from 0 and SNAPSHOT_NONE ends a chain. Buckets are
+     * power_of_two_mix buckets over the hash the map's Hash gives, so a
+     * view has to use a Hash that gives the same values in every process.
+     * Integers are stored in the byte order of the writer; a reader with
+     * other sizes or another byte order rejects the image.
+     *
+     * Only maps whose Key and T are trivially copyable can be saved.
+     */
+static const std::uint64_t SNAPSHOT_NONE = ~static_cast<std::uint64_t>(0);
+
+struct snapshot_header {
+	char magic[8]; // "SJTULHM"
+	std::uint32_t version;
+	std::uint32_t byte_order; // SNAPSHOT_BYTE_ORDER as the writer stores it
+	std::uint32_t entry_size;
+	std::uint32_t value_size;
+	std::uint64_t count;
+	std::uint64_t bucket_count;
+	std::uint64_t entries_offset;
+	std::uint64_t buckets_offset;
+};
+
+static const char SNAPSHOT_MAGIC[8] = {'S', 'J', 'T', 'U', 'L', 'H', 'M', '\0'};
+static const std::uint32_t SNAPSHOT_VERSION = 1;
+static const std::uint32_t SNAPSHOT_BYTE_ORDER = 0x01020304u;
+static const std::uint64_t SNAPSHOT_ALIGNMENT = 64; // of both arrays within the image
+
+template<class Key, class T>
+struct snapshot_entry {
+	typedef pair<const Key, T> value_type;
+
+	std::uint64_t hash;
+	std::uint64_t next; // next entry of the bucket chain
+	alignas(value_type) unsigned char data[sizeof(value_type)];
+
+	const value_type & value() const {
+		return *reinterpret_cast<const value_type *>(data);
+	}
+};
+
+namespace snapshot_detail {
+	inline std::uint64_t aligned(std::uint64_t offset) {
+		return (offset + SNAPSHOT_ALIGNMENT - 1) / SNAPSHOT_ALIGNMENT * SNAPSHOT_ALIGNMENT;
+	}
+
+	// the bucket count a snapshot of n elements is written with
+	inline std::uint64_t buckets_for(std::uint64_t n) {
+		return power_of_two_mix::round(static_cast<size_t>(n + n / 3 + 1));
+	}
+
+	template<class Key, class T>
+	snapshot_header make_header(std::uint64_t count) {
+		snapshot_header header;
+		std::memset(&header, 0, sizeof(header));
+		std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+		header.version = SNAPSHOT_VERSION;
+		header.byte_order = SNAPSHOT_BYTE_ORDER;
+		header.entry_size = sizeof(snapshot_entry<Key, T>);
+		header.value_size = sizeof(pair<const Key, T>);
+		header.count = count;
+		header.bucket_count = buckets_for(count);
+		header.entries_offset = aligned(sizeof(snapshot_header));
+		header.buckets_offset = aligned(header.entries_offset + count * sizeof(snapshot_entry<Key, T>));
+		return header;
+	}
+
+	// whether header describes an image of Key/T entries of size bytes
+	template<class Key, class T>
+	bool valid(const snapshot_header &header, std::uint64_t size) {
+		if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic)) != 0
+			|| header.version != SNAPSHOT_VERSION || header.byte_order != SNAPSHOT_BYTE_ORDER
+			|| header.entry_size != sizeof(snapshot_entry<Key, T>)
+			|| header.value_size != sizeof(pair<const Key, T>)
+			|| header.bucket_count == 0 || (header.bucket_count & (header.bucket_count - 1)) != 0
+			|| header.entries_offset < sizeof(snapshot_header) || header.entries_offset % SNAPSHOT_ALIGNMENT != 0
+			|| header.buckets_offset % SNAPSHOT_ALIGNMENT != 0) {
+			return false;
+		}
+		// every size is checked before it is multiplied, so nothing overflows
+		if (header.entries_offset > size || header.count > (size - header.entries_offset) / header.entry_size) {
+			return false;
+		}
+		std::uint64_t entries_end = header.entries_offset + header.count * header.entry_size;
+		return header.buckets_offset >= entries_end && header.buckets_offset <= size
+			&& header.bucket_count <= (size - header.buckets_offset) / sizeof(std::uint64_t)
+			&& header.bucket_count <= (SNAPSHOT_NONE >> 1);
+	}
+
+	struct stream_sink {
+		std::ostream &out;
+
+		void write(const void *data, size_t n) {
+			if (!out.write(static_cast<const char *>(data), static_cast<std::streamsize>(n))) {
+				throw runtime_error();
+			}
+		}
+	};
+
+	struct stream_source {
+		std::istream &in;
+
+		void read(void *data, size_t n) {
+			if (!in.read(static_cast<char *>(data), static_cast<std::streamsize>(n))) {
+				throw runtime_error();
+			}
+		}
+	};
+
+#ifdef SJTU_LINKED_HASHMAP_POSIX
+	struct fd_sink {
+		int fd;
+
+		void write(const void *data, size_t n) {
+			const char *p = static_cast<const char *>(data);
+			while (n > 0) {
+				ssize_t done = ::write(fd, p, n);
+				if (done < 0 && errno == EINTR) {
+					continue;
+				}
+				if (done <= 0) {
+					throw runtime_error();
+				}
+				p += done;
+				n -= static_cast<size_t>(done);
+			}
+		}
+	};
+
+	struct fd_source {
+		int fd;
+
+		void read(void *data, size_t n) {
+			char *p = static_cast<char *>(data);
+			while (n > 0) {
+				ssize_t done = ::read(fd, p, n);
+				if (done < 0 && errno == EINTR) {
+					continue;
+				}
+				if (done <= 0) {
+					throw runtime_error();
+				}
+				p += done;
+				n -= static_cast<size_t>(done);
+			}
+		}
+	};
+#endif
+
+	template<class Sink>
+	void pad(Sink &sink, std::uint64_t from, std::uint64_t to) {
+		static const char zeros[SNAPSHOT_ALIGNMENT] = {};
+		sink.write(zeros, static_cast<size_t>(to - from));
+	}
+
+	template<class Source>
+	void skip(Source &source, std::uint64_t n) {
+		char buffer[4096];
+		while (n > 0) {
+			size_t step = n < sizeof(buffer) ? static_cast<size_t>(n) : sizeof(buffer);
+			source.read(buffer, step);
+			n -= step;
+		}
+	}
+
+	static const size_t CHUNK = 1024; // entries buffered per write or read
+
+	// writes the image of map: the chains are worked out first, into one
+	// index per element and bucket, then the entries stream out in order
+	template<class Key, class T, class Hash, class Equal, class Allocator, class Engine, class Stats, class Sink>
+	void save(const linked_hashmap<Key, T, Hash, Equal, Allocator, Engine, Stats> &map, Sink &sink) {
+		typedef snapshot_entry<Key, T> entry;
+		typedef typename linked_hashmap<Key, T, Hash, Equal, Allocator, Engine, Stats>::const_iterator const_iterator;
+		static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<T>::value,
+			"only maps of trivially copyable Key and T can be saved");
+		snapshot_header header = make_header<Key, T>(map.size());
+		Hash hasher = map.hash_function();
+		power_of_two_mix bucket_of;
+		bucket_of.resize(static_cast<size_t>(header.bucket_count));
+		std::vector<std::uint64_t> buckets(static_cast<size_t>(header.bucket_count), SNAPSHOT_NONE);
+		std::vector<std::uint64_t> hashes(map.size()), next(map.size());
+		std::uint64_t i = 0;
+		for (const_iterator it = map.cbegin(); it != map.cend(); ++it, ++i) {
+			hashes[i] = static_cast<std::uint64_t>(hasher(it->first));
+			std::uint64_t &bucket = buckets[bucket_of(static_cast<size_t>(hashes[i]))];
+			next[i] = bucket;
+			bucket = i;
+		}
+		sink.write(&header, sizeof(header));
+		pad(sink, sizeof(header), header.entries_offset);
+		std::vector<entry> chunk(CHUNK);
+		i = 0;
+		const_iterator it = map.cbegin();
+		while (it != map.cend()) {
+			size_t n = 0;
+			for (; n < CHUNK && it != map.cend(); ++n, ++it, ++i) {
+				std::memset(&chunk[n], 0, sizeof(entry));
+				chunk[n].hash = hashes[i];
+				chunk[n].next = next[i];
+				std::memcpy(chunk[n].data, &*it, sizeof(chunk[n].data));
+			}
+			sink.write(chunk.data(), n * sizeof(entry));
+		}
+		pad(sink, header.entries_offset + header.count * sizeof(entry), header.buckets_offset);
+		sink.write(buckets.data(), buckets.size() * sizeof(std::uint64_t));
+	}
+
+	// replaces the contents of map with the image source holds
+	template<class Key, class T, class Hash, class Equal, class Allocator, class Engine, class Stats, class Source>
+	void load(linked_hashmap<Key, T, Hash, Equal, Allocator, Engine, Stats> &map, Source &source) {
+		typedef snapshot_entry<Key, T> entry;
+		static_assert(std::is_trivially_copyable<Key>::value && std::is_trivially_copyable<T>::value,
+			"only maps of trivially copyable Key and T can be loaded");
+		snapshot_header header;
+		source.read(&header, sizeof(header));
+		if (!valid<Key, T>(header, SNAPSHOT_NONE)) {
+			throw runtime_error();
+		}
+		skip(source, header.entries_offset - sizeof(header));
+		map.clear();
+		map.reserve(static_cast<size_t>(header.count));
+		std::vector<entry> chunk(CHUNK);
+		for (std::uint64_t left = header.count; left > 0;) {
+			size_t n = left < CHUNK ? static_cast<size_t>(left) : CHUNK;
+			source.read(chunk.data(), n * sizeof(entry));
+			for (size_t i = 0; i < n; ++i) {
+				map.insert(chunk[i].value());
+			}
+			left -= n;
+		}
+		skip(source, header.buckets_offset - header.entries_offset - header.count * sizeof(entry)
+			+ header.bucket_count * sizeof(std::uint64_t));
+	}
+}
+
+/**
+ * writes a snapshot of map to out.
+ *
+ * throw runtime_error if writing fails
+ */
+template<class Key, class T, class Hash, class Equal, class Allocator, class Engine, class Stats>
+void save(const linked_hashmap<Key, T, Hash, Equal, Allocator, Engine, Stats> &map, std::ostream &out) {
+	snapshot_detail::stream_sink sink{out};
+	snapshot_detail::save(map, sink);
+}
+
+/**
+ * replaces the contents of map with the snapshot read from in, which
+ * is left just past it. The elements are inserted in their saved order;
+ * if reading fails halfway, map keeps those read so far.
+ *
+ * throw runtime_error if reading fails or in holds no snapshot of this
+ * Key and T
+ */
+template<class Key, class T, class Hash, class Equal, class Allocator, class Engine, class Stats>
+void load(linked_hashmap<Key, T, Hash, Equal, Allocator, Engine, Stats> &map, std::istream &in) {
+	snapshot_detail::stream_source source{in};
+	snapshot_detail::load(map, source);
+}
+
+#ifdef SJTU_LINKED_HASHMAP_POSIX
+/**
+ * save() and load() on a file descriptor, read and written from its
+ * current offset on
+ */
+template<class Key, class T, class Hash, class Equal, class Allocator, class Engine, class Stats>
+void save(const linked_hashmap<Key, T, Hash, Equal, Allocator, Engine, Stats> &map, int fd) {
+	snapshot_detail::fd_sink sink{fd};
+	snapshot_detail::save(map, sink);
+}
+
+template<class Key, class T, class Hash, class Equal, class Allocator, class Engine, class Stats>
+void load(linked_hashmap<Key, T, Hash, Equal, Allocator, Engine, Stats> &map, int fd) {
+	snapshot_detail::fd_source source{fd};
+	snapshot_detail::load(map, source);
+}
+#endif
+
+    /**
+     * a read-only linked_hashmap over a snapshot image, used in place.
+     *
+     * Constructing it only checks the header: find() follows the chains
+     * of the image and iteration walks its entries in insertion order, so
+     * opening a mapped snapshot costs no deserialization at all. The view
+     * is built either on memory the caller keeps alive, or (on POSIX) on
+     * a file it maps read-only itself and unmaps when destroyed.
+     *
+     * Hash and Equal must behave as those of the map that was saved. Only
+     * the header is checked, not the chains: the image has to come from
+     * save() and be trusted.
+     */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>
+> class mapped_linked_hashmap {
+public:
+	typedef pair<const Key, T> value_type;
+
+private:
+	typedef snapshot_entry<Key, T> entry;
+
+	const entry* entries;
+	const std::uint64_t* buckets;
+	size_t element_count;
+	size_t bucket_total;
+	power_of_two_mix bucket_of;
+	Hash hasher;
+	Equal key_equal;
+	void* mapping; // what the view maps itself, if anything
+	size_t mapping_size;
+
+	void attach(const void *data, size_t size) {
+		snapshot_header header;
+		if (size < sizeof(header) || reinterpret_cast<std::uintptr_t>(data) % SNAPSHOT_ALIGNMENT != 0) {
+			throw runtime_error();
+		}
+		std::memcpy(&header, data, sizeof(header));
+		if (!snapshot_detail::valid<Key, T>(header, size)) {
+			throw runtime_error();
+		}
+		const unsigned char *base = static_cast<const unsigned char *>(data);
+		entries = reinterpret_cast<const entry *>(base + header.entries_offset);
+		buckets = reinterpret_cast<const std::uint64_t *>(base + header.buckets_offset);
+		element_count = static_cast<size_t>(header.count);
+		bucket_total = static_cast<size_t>(header.bucket_count);
+		bucket_of.resize(bucket_total);
+	}
+
+	void unmap() {
+#ifdef SJTU_LINKED_HASHMAP_POSIX
+		if (mapping) {
+			::munmap(mapping, mapping_size);
+		}
+#endif
+		mapping = nullptr;
+	}
+
+	template<class K>
+	const entry* find_entry(const K &key) const {
+		std::uint64_t hash = static_cast<std::uint64_t>(hasher(key));
+		for (std::uint64_t i = buckets[bucket_of(static_cast<size_t>(hash))]; i != SNAPSHOT_NONE;) {
+			const entry &e = entries[i];
+			if (e.hash == hash && key_equal(e.value().first, key)) {
+				return &e;
+			}
+			i = e.next;
+		}
+		return nullptr;
+	}
+
+public:
+	class const_iterator {
+	private:
+		const entry* current;
+		const mapped_linked_hashmap* container;
+
+		friend class mapped_linked_hashmap;
+
+		const_iterator(const entry* current, const mapped_linked_hashmap* container) : current(current), container(container) {}
+
+	public:
+		using difference_type = std::ptrdiff_t;
+		using value_type = const typename mapped_linked_hashmap::value_type;
+		using pointer = value_type*;
+		using reference = value_type&;
+		using iterator_category = std::bidirectional_iterator_tag;
+
+		const_iterator() : current(nullptr), container(nullptr) {}
+
+		const_iterator operator++(int) {
+			const_iterator temp = *this;
+			++*this;
+			return temp;
+		}
+
+		const_iterator & operator++() {
+			if (!container || current == container->entries + container->element_count) {
+				throw invalid_iterator();
+			}
+			++current;
+			return *this;
+		}
+
+		const_iterator operator--(int) {
+			const_iterator temp = *this;
+			--*this;
+			return temp;
+		}
+
+		const_iterator & operator--() {
+			if (!container || current == container->entries) {
+				throw invalid_iterator();
+			}
+			--current;
+			return *this;
+		}
+
+		const value_type & operator*() const {
+			return current->value();
+		}
+
+		const value_type* operator->() const noexcept {
+			return &current->value();
+		}
+
+		bool operator==(const const_iterator &rhs) const {
+			return current == rhs.current && container == rhs.container;
+		}
+
+		bool operator!=(const const_iterator &rhs) const {
+			return !(*this == rhs);
+		}
+	};
+
+	typedef const_iterator iterator;
+
+	/**
+	 * a view of the snapshot at data, which has to stay mapped (and
+	 * unchanged) for the lifetime of the view and be aligned to
+	 * SNAPSHOT_ALIGNMENT bytes, as mmap() and operator new[] of a
+	 * suitably aligned type are.
+	 *
+	 * throw runtime_error if the size bytes at data hold no snapshot of
+	 * this Key and T
+	 */
+	mapped_linked_hashmap(const void *data, size_t size, const Hash &hash = Hash(), const Equal &equal = Equal())
+		: hasher(hash), key_equal(equal), mapping(nullptr), mapping_size(0) {
+		attach(data, size);
+	}
+
+#ifdef SJTU_LINKED_HASHMAP_POSIX
+	/**
+	 * maps the snapshot file at path read-only.
+	 *
+	 * throw runtime_error if it cannot be mapped or holds no snapshot of
+	 * this Key and T
+	 */
+	explicit mapped_linked_hashmap(const char *path, const Hash &hash = Hash(), const Equal &equal = Equal())
+		: hasher(hash), key_equal(equal), mapping(nullptr), mapping_size(0) {
+		int fd = ::open(path, O_RDONLY);
+		if (fd < 0) {
+			throw runtime_error();
+		}
+		struct stat info;
+		if (::fstat(fd, &info) != 0 || info.st_size <= 0) {
+			::close(fd);
+			throw runtime_error();
+		}
+		mapping_size = static_cast<size_t>(info.st_size);
+		void *data = ::mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (data == MAP_FAILED) {
+			throw runtime_error();
+		}
+		mapping = data;
+		try {
+			attach(data, mapping_size);
+		} catch (...) {
+			unmap();
+			throw;
+		}
+	}
+#endif
+
+	mapped_linked_hashmap(const mapped_linked_hashmap &) = delete;
+	mapped_linked_hashmap & operator=(const mapped_linked_hashmap &) = delete;
+
+	/**
+	 * takes over the view and the mapping of other, which is left empty.
+	 */
+	mapped_linked_hashmap(mapped_linked_hashmap &&other)
+		: entries(other.entries), buckets(other.buckets), element_count(other.element_count),
+		bucket_total(other.bucket_total), bucket_of(other.bucket_of), hasher(other.hasher),
+		key_equal(other.key_equal), mapping(other.mapping), mapping_size(other.mapping_size) {
+		other.element_count = 0;
+		other.mapping = nullptr;
+		other.entries = nullptr;
+		other.buckets = &SNAPSHOT_NONE;
+		other.bucket_total = 1;
+		other.bucket_of.resize(1);
+	}
+
+	~mapped_linked_hashmap() {
+		unmap();
+	}
+
+	/**
+	 * throw index_out_of_bound if key is not present
+	 */
+	const T & at(const Key &key) const {
+		const entry *e = find_entry(key);
+		if (!e) {
+			throw index_out_of_bound();
+		}
+		return e->value().second;
+	}
+
+	/**
+	 * behave like at() throw index_out_of_bound if such key does not exist.
+	 */
+	const T & operator[](const Key &key) const {
+		return at(key);
+	}
+
+	/**
+	 * at() without the exception: a pointer to the value mapped to key,
+	 * or nullptr if there is none.
+	 */
+	const T * get(const Key &key) const {
+		const entry *e = find_entry(key);
+		return e ? &e->value().second : nullptr;
+	}
+
+	/**
+	 * copies the value mapped to key into out. returns false, leaving out
+	 * alone, if key is not present.
+	 */
+	bool try_get(const Key &key, T &out) const {
+		const T *value = get(key);
+		if (!value) {
+			return false;
+		}
+		out = *value;
+		return true;
+	}
+
+	const_iterator begin() const {
+		return const_iterator(entries, this);
+	}
+
+	const_iterator cbegin() const {
+		return const_iterator(entries, this);
+	}
+
+	const_iterator end() const {
+		return const_iterator(entries + element_count, this);
+	}
+
+	const_iterator cend() const {
+		return const_iterator(entries + element_count, this);
+	}
+
+	bool empty() const {
+		return element_count == 0;
+	}
+
+	size_t size() const {
+		return element_count;
+	}
+
+	size_t bucket_count() const {
+		return bucket_total;
+	}
+
+	size_t count(const Key &key) const {
+		return find_entry(key) ? 1 : 0;
+	}
+
+	const_iterator find(const Key &key) const {
+		const entry *e = find_entry(key);
+		return e ? const_iterator(e, this) : cend();
+	}
+};
+
+}
+
+#endif
@@ -0,0 +1,116 @@
+/**
+ * runs a perf workload and holds it to its recorded baseline.
+ *
+ *   perf_run <baselines> <name> <time tolerance> <memory tolerance> <program> [args...]
+ *
+ * program runs as a child process, its output discarded. Its wall time
+ * and peak resident set (ru_maxrss, as wait4 reports it) are printed
+ * in the format of the baseline file:
+ *
+ *   # name         wall_ms   peak_rss_kb
+ *   stress_two     1000      60000
+ *
+ * so recording a new baseline is pasting that line over the old one.
+ * The run fails if program fails, or takes longer than tolerance times
+ * its baseline (plus SLACK_MS, so short runs do not fail on noise), or
+ * needs more memory than its tolerance allows. A name with no baseline
+ * is reported as skipped (exit status 77).
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+
+const double SLACK_MS = 50;
+const int SKIPPED = 77;
+
+struct baseline {
+	double wall_ms;
+	double peak_rss_kb;
+};
+
+bool find_baseline(const char *path, const std::string &name, baseline &out) {
+	std::ifstream in(path);
+	std::string line;
+	while (std::getline(in, line)) {
+		std::istringstream fields(line);
+		std::string first;
+		if (!(fields >> first) || first[0] == '#' || first != name) {
+			continue;
+		}
+		return static_cast<bool>(fields >> out.wall_ms >> out.peak_rss_kb);
+	}
+	return false;
+}
+
+}
+
+int main(int argc, char **argv) {
+	if (argc < 6) {
+		std::fprintf(stderr, "usage: perf_run <baselines> <name> <time tolerance> <memory tolerance> <program> [args...]\n");
+		return 2;
+	}
+	const std::string name = argv[2];
+	const double time_tolerance = std::atof(argv[3]);
+	const double memory_tolerance = std::atof(argv[4]);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	pid_t child = fork();
+	if (child < 0) {
+		std::perror("perf_run: fork");
+		return 2;
+	}
+	if (child == 0) {
+		int null = open("/dev/null", O_WRONLY);
+		if (null >= 0) {
+			dup2(null, STDOUT_FILENO);
+		}
+		execv(argv[5], argv + 5);
+		std::perror("perf_run: exec");
+		_exit(127);
+	}
+	int status = 0;
+	struct rusage usage;
+	std::memset(&usage, 0, sizeof(usage));
+	if (wait4(child, &status, 0, &usage) < 0) {
+		std::perror("perf_run: wait4");
+		return 2;
+	}
+	double wall_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	double peak_rss_kb = static_cast<double>(usage.ru_maxrss);
+
+	std::printf("%-16s %-9.0f %.0f\n", name.c_str(), wall_ms, peak_rss_kb);
+	if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+		std::printf("%s: the workload failed\n", name.c_str());
+		return 1;
+	}
+	baseline base;
+	if (!find_baseline(argv[1], name, base)) {
+		std::printf("%s: no baseline in %s\n", name.c_str(), argv[1]);
+		return SKIPPED;
+	}
+	bool ok = true;
+	double time_limit = base.wall_ms * time_tolerance + SLACK_MS;
+	if (wall_ms > time_limit) {
+		std::printf("%s: %.0f ms, over the %.0f ms allowed (baseline %.0f ms)\n", name.c_str(), wall_ms, time_limit,
+			base.wall_ms);
+		ok = false;
+	}
+	double memory_limit = base.peak_rss_kb * memory_tolerance;
+	if (peak_rss_kb > memory_limit) {
+		std::printf("%s: %.0f kB peak, over the %.0f kB allowed (baseline %.0f kB)\n", name.c_str(), peak_rss_kb,
+			memory_limit, base.peak_rss_kb);
+		ok = false;
+	}
+	return ok ? 0 : 1;
+}
@@ -0,0 +1,137 @@
+/**
+ * the workload of data/testthree, scaled up: int maps filled through
+ * count() and operator[] or insert(), walked in both directions, thinned
+ * out by find() and erase(), drained from begin(), and refilled with
+ * keys that repeat. Lines the OJ test prints go into a checksum.
+ *
+ *   perf_stress_three [elements]
+ *
+ * Exits non-zero if the map loses track of an element.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "linked_hashmap.hpp"
+
+namespace {
+
+unsigned long long state = 233;
+
+int next_random() {
+	state = state * 6364136223846793005ull + 1442695040888963407ull;
+	return static_cast<int>(state >> 33);
+}
+
+typedef sjtu::linked_hashmap<int, int> map_type;
+
+unsigned long long checksum = 0;
+
+bool fail(const char *what) {
+	std::fprintf(stderr, "perf_stress_three: %s\n", what);
+	return false;
+}
+
+void walk(const map_type &map) {
+	for (map_type::const_iterator it = map.cbegin(); it != map.cend(); ++it) {
+		checksum += it->first ^ it->second;
+	}
+	if (map.empty()) {
+		return;
+	}
+	for (map_type::const_iterator it = --map.cend(); it != map.cbegin(); --it) {
+		checksum += it->second;
+	}
+}
+
+// check1 and check4: fill with random keys, through [] and insert()
+bool fill(int n) {
+	map_type map;
+	for (int i = 0; i < n; ++i) {
+		int a = next_random(), b = next_random();
+		if (!map.count(a)) {
+			map[a] = b;
+		}
+	}
+	for (int i = 0; i < n; ++i) {
+		int a = next_random(), b = next_random();
+		if (!map.count(a)) {
+			map.insert(map_type::value_type(a, b));
+		}
+	}
+	walk(map);
+	return map.size() <= static_cast<size_t>(2 * n) || fail("fill: too many elements");
+}
+
+// check3: distinct keys, a third of them erased through find()
+bool thin(int n) {
+	std::vector<int> keys(n);
+	int key = 0;
+	for (int i = 0; i < n; ++i) {
+		key += next_random() % 325 + 1;
+		keys[i] = key;
+	}
+	for (int i = n - 1; i > 0; --i) {
+		std::swap(keys[i], keys[next_random() % (i + 1)]);
+	}
+	map_type map;
+	for (int i = 0; i < n; ++i) {
+		map[keys[i]] = next_random();
+	}
+	for (int i = n - 1; i > 0; --i) {
+		std::swap(keys[i], keys[next_random() % (i + 1)]);
+	}
+	int erased = n / 3;
+	for (int i = 0; i < erased; ++i) {
+		map.erase(map.find(keys[i]));
+	}
+	walk(map);
+	return map.size() == static_cast<size_t>(n - erased) || fail("thin: wrong size after erasing");
+}
+
+// check5: drain from begin(), then insert keys that come twice, erasing
+// each on its second coming
+bool drain(int n) {
+	map_type map;
+	for (int i = 0; i < n; ++i) {
+		int a = next_random();
+		if (!map.count(a)) {
+			map[a] = next_random();
+		}
+	}
+	while (!map.empty()) {
+		checksum += map.begin()->first;
+		map.erase(map.begin());
+	}
+	int half = n / 2;
+	std::vector<int> keys(n);
+	for (int i = 0; i < n; ++i) {
+		keys[i] = i % half;
+	}
+	for (int i = n - 1; i > 0; --i) {
+		std::swap(keys[i], keys[next_random() % (i + 1)]);
+	}
+	for (int i = 0; i < n; ++i) {
+		map_type::iterator it = map.find(keys[i]);
+		if (it != map.end()) {
+			map.erase(it);
+		} else {
+			map[keys[i]] = keys[i];
+		}
+	}
+	walk(map);
+	return map.empty() || fail("drain: keys left after their second coming");
+}
+
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 1000000;
+	for (int round = 0; round < 2; ++round) {
+		if (!fill(n) || !thin(n) || !drain(n)) {
+			return 1;
+		}
+	}
+	std::printf("%llu\n", checksum);
+	return 0;
+}
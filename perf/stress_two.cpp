@@ -0,0 +1,128 @@
+/**
+ * the workload of data/testtwo, scaled up: non-trivial keys and values,
+ * operator[] and insert() each followed by ten lookups of earlier keys,
+ * full ordered traversals, a copy, and erasing everything through
+ * find() in another order. The OJ test prints every lookup; this one
+ * folds them into a checksum, so that the time measured is the map's.
+ *
+ *   perf_stress_two [elements]
+ *
+ * Exits non-zero if the map loses track of an element.
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+#include "linked_hashmap.hpp"
+
+namespace {
+
+unsigned long long state = 233;
+
+int next_random() {
+	state = state * 6364136223846793005ull + 1442695040888963407ull;
+	return static_cast<int>(state >> 33);
+}
+
+class IntA {
+public:
+	int val;
+
+	IntA(int val) : val(val) {}
+	IntA(const IntA &rhs) : val(rhs.val) {}
+};
+
+class IntB {
+public:
+	int *val;
+
+	explicit IntB(int val = 0) : val(new int(val)) {}
+
+	IntB(const IntB &rhs) : val(new int(*rhs.val)) {}
+
+	IntB & operator=(const IntB &rhs) {
+		if (this != &rhs) {
+			delete val;
+			val = new int(*rhs.val);
+		}
+		return *this;
+	}
+
+	~IntB() {
+		delete val;
+	}
+};
+
+struct Equal {
+	bool operator()(const IntA &a, const IntA &b) const {
+		return a.val == b.val;
+	}
+};
+
+struct Hash {
+	size_t operator()(const IntA &a) const {
+		return std::hash<int>()(a.val);
+	}
+};
+
+typedef sjtu::linked_hashmap<IntA, IntB, Hash, Equal> map_type;
+
+bool fail(const char *what) {
+	std::fprintf(stderr, "perf_stress_two: %s\n", what);
+	return false;
+}
+
+bool run(int n) {
+	std::vector<int> keys(n);
+	for (int i = 0; i < n; ++i) {
+		keys[i] = next_random();
+	}
+	unsigned long long checksum = 0;
+	map_type map;
+	for (int i = 0; i < n; ++i) {
+		if (i % 2 == 0) {
+			map[keys[i]] = IntB(next_random());
+		} else {
+			map.insert(map_type::value_type(keys[i], IntB(next_random())));
+		}
+		for (int c = 0; c < 10; ++c) {
+			checksum += *map[keys[next_random() % (i + 1)]].val;
+		}
+	}
+	for (map_type::iterator it = map.begin(); it != map.end(); ++it) {
+		checksum += it->first.val;
+	}
+	map_type copy(map);
+	for (map_type::const_iterator it = --copy.cend(); it != copy.cbegin(); --it) {
+		checksum += *it->second.val;
+	}
+	for (int i = n - 1; i > 0; --i) {
+		std::swap(keys[i], keys[next_random() % (i + 1)]);
+	}
+	for (int i = 0; i < n; ++i) {
+		map_type::iterator it = map.find(keys[i]);
+		if (it != map.end()) {
+			map.erase(it);
+		}
+		for (int c = 0; c < 10; ++c) {
+			if (map.find(keys[next_random() % n]) != map.end()) {
+				++checksum;
+			}
+		}
+	}
+	if (!map.empty()) {
+		return fail("elements left after erasing every key");
+	}
+	if (copy.size() == 0 || copy.size() > static_cast<size_t>(n)) {
+		return fail("copy has the wrong size");
+	}
+	std::printf("%llu\n", checksum);
+	return true;
+}
+
+}
+
+int main(int argc, char **argv) {
+	int n = argc > 1 ? std::atoi(argv[1]) : 400000;
+	return run(n) ? 0 : 1;
+}
@@ -0,0 +1,346 @@
+/**
+ * a read-mostly sjtu::linked_hashmap whose readers never take a lock
+ */
+#ifndef SJTU_RCU_LINKED_HASHMAP_HPP
+#define SJTU_RCU_LINKED_HASHMAP_HPP
+
+#include <functional>
+#include <cstddef>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "linked_hashmap.hpp"
+
+namespace sjtu {
+    /**
+     * rcu_linked_hashmap publishes its contents as immutable versions of a
+     * linked_hashmap, in the manner of read-copy-update.
+     *
+     * Readers need no locks. They announce themselves in a reader counter,
+     * load the current version and use it as an ordinary const
+     * linked_hashmap: find() and ordered iteration run on plain loads,
+     * because a published version is never written again.
+     *
+     * Writers serialize on a mutex. Each update copies the current version
+     * (the structural copy of linked_hashmap), changes the copy, and
+     * publishes it with one atomic store. The old version is retired and
+     * freed by a later update once every reader that could still see it
+     * has left; writers never wait for readers. An update costs a copy of
+     * the map, which suits tables read millions of times for every change;
+     * update() batches several changes into one copy, and reclaim() frees
+     * retired versions between updates.
+     *
+     * Memory ordering is defined here, not by the user:
+     *   - the version pointer is stored after the copy is complete and
+     *     loaded by readers with sequentially consistent atomics, so a
+     *     reader sees the bucket array and the list_next chain of its
+     *     version fully built;
+     *   - readers enter one of two reader phases, given by the parity of
+     *     an epoch that writers advance whenever the other phase has
+     *     drained; a version replaced in epoch e is freed from epoch e + 2
+     *     on, when both phases have drained since;
+     *   - counters are striped over cache lines by thread, so readers
+     *     on different cores rarely touch the same line.
+     */
+template<
+	class Key,
+	class T,
+	class Hash = std::hash<Key>,
+	class Equal = std::equal_to<Key>,
+	class Allocator = pool_allocator<pair<const Key, T> >,
+	class Engine = SJTU_LINKED_HASHMAP_DEFAULT_ENGINE
+> class rcu_linked_hashmap {
+public:
+	typedef linked_hashmap<Key, T, Hash, Equal, Allocator, Engine> map_type;
+	typedef typename map_type::value_type value_type;
+	typedef typename map_type::const_iterator const_iterator;
+
+private:
+	static const size_t STRIPES = 16;
+
+	struct alignas(64) stripe {
+		std::atomic<size_t> readers;
+	};
+
+	// a replaced version waiting until no reader can see it
+	struct retired {
+		const map_type *version;
+		unsigned long long epoch; // the epoch it was replaced in
+		retired *next;
+	};
+
+	std::atomic<const map_type *> current;
+	std::atomic<unsigned long long> epoch; // readers enter phase epoch & 1
+	mutable stripe counters[2][STRIPES];
+	std::mutex writer;
+	retired *retired_list; // newest first
+
+	static size_t my_stripe() {
+		static thread_local size_t index = std::hash<std::thread::id>()(std::this_thread::get_id()) % STRIPES;
+		return index;
+	}
+
+	// returns the phase entered, to be handed back to leave()
+	unsigned int enter() const {
+		unsigned int p = static_cast<unsigned int>(epoch.load() & 1);
+		counters[p][my_stripe()].readers.fetch_add(1);
+		return p;
+	}
+
+	void leave(unsigned int p) const {
+		counters[p][my_stripe()].readers.fetch_sub(1);
+	}
+
+	bool drained(unsigned int p) const {
+		for (size_t i = 0; i < STRIPES; ++i) {
+			if (counters[p][i].readers.load() != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	// frees every retired version no reader can see any more, without
+	// waiting; the caller holds the writer mutex.
+	//
+	// The epoch only advances once the phase readers are not entering has
+	// drained. A reader holding a version entered a phase before that
+	// version was replaced, and both phases have drained by the time the
+	// epoch has advanced twice since, so such a reader is gone.
+	void reclaim_locked() {
+		for (int i = 0; i < 2; ++i) {
+			unsigned long long e = epoch.load();
+			if (!drained(static_cast<unsigned int>((e & 1) ^ 1))) {
+				break;
+			}
+			epoch.store(e + 1);
+		}
+		unsigned long long now = epoch.load();
+		retired **link = &retired_list;
+		while (*link && (*link)->epoch + 2 > now) {
+			link = &(*link)->next;
+		}
+		retired *r = *link;
+		*link = nullptr;
+		while (r) {
+			retired *next = r->next;
+			delete r->version;
+			delete r;
+			r = next;
+		}
+	}
+
+	// runs f on the unpublished copy next, which is dropped if f throws
+	template<class F>
+	static auto apply(F &f, map_type *next) -> decltype(f(*next)) {
+		try {
+			return f(*next);
+		} catch (...) {
+			delete next;
+			throw;
+		}
+	}
+
+	// makes next the current version and retires the old one; the caller
+	// holds the writer mutex
+	void publish(map_type *next) {
+		retired *r;
+		try {
+			r = new retired;
+		} catch (...) {
+			delete next;
+			throw;
+		}
+		r->version = current.load();
+		current.store(next);
+		r->epoch = epoch.load();
+		r->next = retired_list;
+		retired_list = r;
+		reclaim_locked();
+	}
+
+	template<class F>
+	void update_locked(F &f, std::true_type) {
+		map_type *next = new map_type(*current.load());
+		apply(f, next);
+		publish(next);
+	}
+
+	template<class F>
+	auto update_locked(F &f, std::false_type) -> decltype(f(std::declval<map_type &>())) {
+		map_type *next = new map_type(*current.load());
+		auto result = apply(f, next);
+		publish(next);
+		return result;
+	}
+
+public:
+	/**
+	 * pins the version that was current when it was made, for as long as
+	 * it lives. Everything reached through it, iterators included, stays
+	 * valid and unchanged meanwhile; updates published later are not seen.
+	 * Writers never wait for snapshots, but the versions they replace stay
+	 * allocated until the snapshots of that time are gone.
+	 */
+	class snapshot {
+	private:
+		const rcu_linked_hashmap *owner;
+		unsigned int entered;
+		const map_type *version;
+
+		friend class rcu_linked_hashmap;
+
+		explicit snapshot(const rcu_linked_hashmap *owner)
+			: owner(owner), entered(owner->enter()), version(owner->current.load()) {}
+
+	public:
+		snapshot(snapshot &&other) : owner(other.owner), entered(other.entered), version(other.version) {
+			other.owner = nullptr;
+		}
+
+		snapshot(const snapshot &) = delete;
+		snapshot & operator=(const snapshot &) = delete;
+		snapshot & operator=(snapshot &&) = delete;
+
+		~snapshot() {
+			if (owner) {
+				owner->leave(entered);
+			}
+		}
+
+		const map_type & operator*() const {
+			return *version;
+		}
+
+		const map_type * operator->() const {
+			return version;
+		}
+	};
+
+	rcu_linked_hashmap() : current(new map_type), epoch(0), retired_list(nullptr) {
+		for (size_t p = 0; p < 2; ++p) {
+			for (size_t i = 0; i < STRIPES; ++i) {
+				counters[p][i].readers.store(0);
+			}
+		}
+	}
+
+	rcu_linked_hashmap(const rcu_linked_hashmap &) = delete;
+	rcu_linked_hashmap & operator=(const rcu_linked_hashmap &) = delete;
+
+	// no reader may be left when the map goes away
+	~rcu_linked_hashmap() {
+		while (retired_list) {
+			retired *next = retired_list->next;
+			delete retired_list->version;
+			delete retired_list;
+			retired_list = next;
+		}
+		delete current.load();
+	}
+
+	snapshot read() const {
+		return snapshot(this);
+	}
+
+	size_t size() const {
+		return read()->size();
+	}
+
+	bool empty() const {
+		return read()->empty();
+	}
+
+	size_t count(const Key &key) const {
+		return read()->count(key);
+	}
+
+	/**
+	 * copies the value of key into out. returns false, leaving out
+	 * alone, if key is not present.
+	 */
+	bool find(const Key &key, T &out) const {
+		snapshot s = read();
+		const_iterator it = s->find(key);
+		if (it == s->cend()) {
+			return false;
+		}
+		out = it->second;
+		return true;
+	}
+
+	/**
+	 * calls f(const value_type &) on every element of the current version,
+	 * in insertion order.
+	 */
+	template<class F>
+	void for_each(F f) const {
+		snapshot s = read();
+		for (const_iterator it = s->cbegin(); it != s->cend(); ++it) {
+			f(*it);
+		}
+	}
+
+	/**
+	 * applies f(map_type &) to a copy of the current version and publishes
+	 * the result as one update. returns what f returned.
+	 */
+	template<class F>
+	auto update(F f) -> decltype(f(std::declval<map_type &>())) {
+		std::lock_guard<std::mutex> guard(writer);
+		return update_locked(f, std::is_void<decltype(f(std::declval<map_type &>()))>());
+	}
+
+	/**
+	 * inserts value unless its key is present; returns whether it was
+	 * inserted. A key that is present already costs a lookup, not a copy.
+	 */
+	bool insert(const value_type &value) {
+		if (count(value.first)) {
+			return false;
+		}
+		return update([&value](map_type &map) {
+			return map.insert(value).second;
+		});
+	}
+
+	/**
+	 * stores obj under key, replacing the value of a present key.
+	 * returns whether key was new.
+	 */
+	template<class M>
+	bool insert_or_assign(const Key &key, M &&obj) {
+		return update([&key, &obj](map_type &map) {
+			return map.insert_or_assign(key, std::forward<M>(obj)).second;
+		});
+	}
+
+	size_t erase(const Key &key) {
+		if (!count(key)) {
+			return 0;
+		}
+		return update([&key](map_type &map) {
+			return map.erase(key);
+		});
+	}
+
+	void clear() {
+		std::lock_guard<std::mutex> guard(writer);
+		publish(new map_type);
+	}
+
+	/**
+	 * frees the retired versions that no reader can see any more, as every
+	 * update does. Never waits.
+	 */
+	void reclaim() {
+		std::lock_guard<std::mutex> guard(writer);
+		reclaim_locked();
+	}
+};
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define SJTU_UTILITY_HPP
 
 #include <utility>
+#include <tuple>
 
 namespace sjtu {
 
@@ -15,11 +16,20 @@ public:
 	pair(pair &&other) = default;
 	pair(const T1 &x, const T2 &y) : first(x), second(y) {}
 	template<class U1, class U2>
-	pair(U1 &&x, U2 &&y) : first(x), second(y) {}
+	pair(U1 &&x, U2 &&y) : first(std::forward<U1>(x)), second(std::forward<U2>(y)) {}
 	template<class U1, class U2>
 	pair(const pair<U1, U2> &other) : first(other.first), second(other.second) {}
 	template<class U1, class U2>
-	pair(pair<U1, U2> &&other) : first(other.first), second(other.second) {}
+	pair(pair<U1, U2> &&other) : first(std::move(other.first)), second(std::move(other.second)) {}
+	// builds first and second in place from the two argument tuples
+	template<class... Args1, class... Args2>
+	pair(std::piecewise_construct_t, std::tuple<Args1...> a, std::tuple<Args2...> b)
+		: pair(a, b, std::index_sequence_for<Args1...>(), std::index_sequence_for<Args2...>()) {}
+
+private:
+	template<class A, class B, std::size_t... I, std::size_t... J>
+	pair(A &a, B &b, std::index_sequence<I...>, std::index_sequence<J...>)
+		: first(std::get<I>(std::move(a))...), second(std::get<J>(std::move(b))...) {}
 };
 
 }